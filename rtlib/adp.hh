@@ -36,6 +36,7 @@
 #include "sequence.hh"
 #include "string.hh"
 #include "table.hh"
+#include "soa.hh"
 #include "terminal.hh"
 
 #include "filter.hh"
@@ -45,8 +46,11 @@
 #include "output.hh"
 
 #include "push_back.hh"
+#include "top_k.hh"
+#include "pareto_stream.hh"
 
 #include "shape.hh"
+#include "dotbracket.hh"
 
 #include "bigint.hh"
 
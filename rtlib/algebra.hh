@@ -308,10 +308,12 @@ template <typename Iterator>
 inline
 typename std::iterator_traits<Iterator>::value_type
 sample(std::pair<Iterator, Iterator> &p) {
-  Singleton<scil::ran_discrete>::ref().clear();
+  scil::ran_discrete &d = scil::local_ran_discrete();
+  d.clear();
   for (; p.first != p.second; ++p.first)
-    Singleton<scil::ran_discrete>::ref().push_back(*p.first);
-  return Singleton<scil::ran_discrete>::ref().sample();
+    d.push_back(*p.first);
+  d.init();
+  return d.sample();
 }
 
 struct DoubleToDouble {
@@ -320,6 +322,12 @@ struct DoubleToDouble {
   }
 };
 
+// the samples of a batch a chosen candidate is descended with, see
+// rtlib/backtrack.hh
+template<typename T>
+inline void set_batch(T &, const std::vector<unsigned> &) {
+}
+
 template<typename S, typename T, typename pos_int, typename XToDouble>
 inline
 List_Ref<std::pair<S, T>, pos_int>
@@ -328,19 +336,36 @@ sample_filter(List_Ref<std::pair<S, T>, pos_int> &x,
   List<std::pair<S, T>, pos_int> &l = x.ref();
   List_Ref<std::pair<S, T>, pos_int> ret;
   List<std::pair<S, T>, pos_int> &r = ret.ref();
-  Singleton<scil::ran_discrete>::ref().clear();
-  for (typename List<std::pair<S, T>, pos_int>::iterator i = l.begin();
-       i != l.end(); ++i)
-    Singleton<scil::ran_discrete>::ref().push_back(todouble((*i).first));
-  Singleton<scil::ran_discrete>::ref().init();
-  size_t s = Singleton<scil::ran_discrete>::ref().sample();
+  scil::ran_discrete &d = scil::local_ran_discrete();
+  if (!d.init_cached(l.size())) {
+    d.clear();
+    for (typename List<std::pair<S, T>, pos_int>::iterator i = l.begin();
+         i != l.end(); ++i)
+      d.push_back(todouble((*i).first));
+    d.init();
+  }
+#ifdef SAMPLE_BATCH
+  // partition the samples of the cell among the candidates, each sample
+  // draws from its own stream
+  std::vector<std::vector<unsigned> > parts(l.size());
+  const std::vector<unsigned> &b = scil::batch();
+  for (std::vector<unsigned>::const_iterator i = b.begin(); i != b.end();
+       ++i) {
+    scil::batch_sample s(*i);
+    parts[d.sample()].push_back(*i);
+  }
+  std::vector<std::vector<unsigned> >::iterator k = parts.begin();
   for (typename List<std::pair<S, T>, pos_int>::iterator i = l.begin();
-       i != l.end(); ++i, --s)
-    if (!s) {
+       i != l.end(); ++i, ++k)
+    if (!k->empty()) {
       r.push_back(*i);
-      break;
+      set_batch(r.back().second, *k);
     }
-  assert(r.size() < 2);
+#else
+  size_t s = d.sample();
+  assert(s < l.size());
+  r.push_back(l[s]);
+#endif
   return ret;
 }
 
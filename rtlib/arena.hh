@@ -0,0 +1,240 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_ARENA_HH_
+#define RTLIB_ARENA_HH_
+
+// The Map::Pool free lists behind Pool and MultiPool are shared by all
+// threads, i.e. they are not safe under OpenMP CYK. Thus, parallel builds
+// allocate from per thread arenas by default - or from the system malloc,
+// if the arenas are disabled by NO_ARENA.
+#if defined(_OPENMP) && !defined(NO_ARENA) && !defined(USE_ARENA)
+  #define USE_ARENA
+#endif
+
+#if defined(_OPENMP) && !defined(USE_ARENA)
+  #define USE_SYSTEM_MALLOC
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "map_pool.hh"
+
+// Per thread arena allocator which serves all rtlib heap types
+// (String and rope blocks, Shape arrays, Hash::Set objects) if
+// USE_ARENA is defined.
+//
+// Each thread owns one Heap: a chain of big chunks carved by a bump
+// pointer plus one free list per size class. An object freed by another
+// thread than the allocating one just lands on the free list of the
+// freeing thread, thus malloc/free never lock. All heaps are registered
+// globally, such that reset() rewinds every arena in one go once all cells
+// are dead - instead of freeing millions of cells one by one.
+
+namespace Arena {
+
+enum {
+  ALIGN = 16,
+  // larger requests are forwarded to the system malloc
+  MAX_CLASS = 4096,
+  CLASSES = MAX_CLASS / ALIGN,
+  CHUNK_SIZE = 32 * 1024 * 1024
+};
+
+class Heap {
+ private:
+    struct Free {
+      Free *next;
+    };
+
+#ifdef NO_MMAP
+    Map::MallocMapper mapper;
+#else
+    Map::MapMapper mapper;
+#endif
+
+    std::vector<unsigned char*> chunks;
+    // index of the chunk the bump pointer points into
+    size_t chunk;
+    unsigned char *cur;
+    unsigned char *end;
+    Free *heads[CLASSES];
+
+    Heap(const Heap &);
+    Heap &operator=(const Heap&);
+
+    static size_t size_class(size_t bytes) {
+      return (bytes + ALIGN - 1) / ALIGN - 1;
+    }
+
+    void next_chunk() {
+      if (cur)
+        ++chunk;
+      if (chunk == chunks.size())
+        chunks.push_back(static_cast<unsigned char*>(mapper.map(CHUNK_SIZE)));
+      cur = chunks[chunk];
+      end = cur + CHUNK_SIZE;
+    }
+
+    void clear_free_lists() {
+      std::memset(heads, 0, sizeof(heads));
+    }
+
+ public:
+    Heap() : chunk(0), cur(0), end(0) {
+      clear_free_lists();
+    }
+
+    ~Heap() {
+      release();
+    }
+
+    void *malloc(size_t bytes) {
+      assert(bytes);
+      if (bytes > MAX_CLASS) {
+        void *r = std::malloc(bytes);
+        assert(r);
+        return r;
+      }
+      size_t k = size_class(bytes);
+      if (heads[k]) {
+        Free *r = heads[k];
+        heads[k] = r->next;
+        return r;
+      }
+      size_t l = (k + 1) * ALIGN;
+      if (cur + l > end)
+        next_chunk();
+      void *r = cur;
+      cur += l;
+      return r;
+    }
+
+    void free(void *x, size_t bytes) {
+      assert(x);
+      if (bytes > MAX_CLASS) {
+        std::free(x);
+        return;
+      }
+      size_t k = size_class(bytes);
+      Free *f = static_cast<Free*>(x);
+      f->next = heads[k];
+      heads[k] = f;
+    }
+
+    // All objects allocated from this heap are dead afterwards. The
+    // chunks stay mapped and are reused by the next input.
+    void reset() {
+      clear_free_lists();
+      chunk = 0;
+      if (chunks.empty()) {
+        cur = end = 0;
+      } else {
+        cur = chunks.front();
+        end = cur + CHUNK_SIZE;
+      }
+    }
+
+    void release() {
+      for (std::vector<unsigned char*>::iterator i = chunks.begin();
+           i != chunks.end(); ++i)
+        mapper.unmap(*i, CHUNK_SIZE);
+      chunks.clear();
+      clear_free_lists();
+      chunk = 0;
+      cur = end = 0;
+    }
+
+    size_t mapped() const {
+      return chunks.size() * CHUNK_SIZE;
+    }
+};
+
+class Registry {
+ private:
+    std::mutex mutex;
+    std::vector<Heap*> heaps;
+
+ public:
+    // heaps are never deleted when a thread exits, because their objects
+    // may still be referenced from tables filled by that thread
+    Heap *add() {
+      Heap *h = new Heap();
+      std::lock_guard<std::mutex> lock(mutex);
+      heaps.push_back(h);
+      return h;
+    }
+
+    void reset() {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (std::vector<Heap*>::iterator i = heaps.begin();
+           i != heaps.end(); ++i)
+        (*i)->reset();
+    }
+
+    void release() {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (std::vector<Heap*>::iterator i = heaps.begin();
+           i != heaps.end(); ++i)
+        (*i)->release();
+    }
+
+    size_t mapped() {
+      std::lock_guard<std::mutex> lock(mutex);
+      size_t r = 0;
+      for (std::vector<Heap*>::iterator i = heaps.begin();
+           i != heaps.end(); ++i)
+        r += (*i)->mapped();
+      return r;
+    }
+};
+
+inline Registry &registry() {
+  static Registry r;
+  return r;
+}
+
+inline Heap &local() {
+  static thread_local Heap *heap = 0;
+  if (!heap)
+    heap = registry().add();
+  return *heap;
+}
+
+// O(1) per thread: call only when no object of any rtlib type is alive
+// anymore, e.g. between two inputs of a batch run
+inline void reset() {
+  registry().reset();
+}
+
+inline void release() {
+  registry().release();
+}
+
+}  // namespace Arena
+
+#endif  // RTLIB_ARENA_HH_
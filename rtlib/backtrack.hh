@@ -24,34 +24,93 @@
 #ifndef RTLIB_BACKTRACK_HH_
 #define RTLIB_BACKTRACK_HH_
 
+#include <algorithm>
 #include <cassert>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
-// FIXME replace with more efficient version
-#include <list>
-
+#include <boost/cstdint.hpp>
 #include <boost/intrusive_ptr.hpp>
 using boost::intrusive_ptr;
 
+#include "multipool.hh"
+#ifdef SAMPLE_BATCH
+#include "sample.hh"
+#endif
+
+// Backtrace objects, their lists and Eval_Lists come from size class
+// pools (or the per thread arena under USE_ARENA) instead of the system
+// malloc. The pool is never destructed, since nodes may still be
+// referenced during static destruction.
+//
+// FIXME this only speeds up the allocation - the nodes are still single,
+// reference counted objects with a virtual eval, i.e. there is no flat
+// node array with type tags and an iterative evaluation. That needs a
+// generic eval in place of the generated node classes.
+struct Backtrace_Alloc {
+  struct Word {
+    uint64_t a, b;
+  };
+
+  static MultiPool<Word> &pool() {
+    static MultiPool<Word> *p = new MultiPool<Word>();
+    return *p;
+  }
+
+  static size_t words(size_t bytes) {
+    return (bytes + sizeof(Word) - 1) / sizeof(Word);
+  }
+
+  static void *operator new(size_t bytes) {
+    return pool().malloc(words(bytes));
+  }
+
+  // called with the size of the dynamic type, due to the virtual
+  // destructors of the node classes
+  static void operator delete(void *x, size_t bytes) {
+    pool().free(static_cast<Word*>(x), words(bytes));
+  }
+};
+
 template<typename Value>
-class Eval_List {
+class Eval_List : public Backtrace_Alloc {
  private:
-    // FIXME more efficient version ...
-    std::list<Value> list;
+    std::vector<Value> list;
+#ifdef SAMPLE_BATCH
+    std::vector<unsigned> ids;
+#endif
 
  public:
     size_t count;
     Eval_List()
       : count(0) {
     }
-    typedef typename std::list<Value>::iterator iterator;
+    typedef typename std::vector<Value>::iterator iterator;
     iterator begin() { return list.begin(); }
     iterator end() { return list.end(); }
     void push_back(Value &v) { list.push_back(v); }
+#ifdef SAMPLE_BATCH
+    size_t size() const { return list.size(); }
+
+    // --sample-batch: each value belongs to one sample of the batch
+    void push_back(unsigned i, Value &v) {
+      ids.push_back(i);
+      list.push_back(v);
+    }
+    unsigned id(size_t i) const { return ids[i]; }
+
+    // end of the values of sample i, which start at pos
+    size_t batch_end(size_t pos, unsigned i) const {
+      while (pos < ids.size() && ids[pos] == i)
+        ++pos;
+      return pos;
+    }
+#endif
 
     template<typename O, typename T>
       void print(O &out, const T &v) {
-        for (typename std::list<Value>::iterator i = list.begin();
+        for (typename std::vector<Value>::iterator i = list.begin();
              i != list.end(); ++i) {
           out << v << " | " << *i << "\n";
         }
@@ -59,11 +118,16 @@ class Eval_List {
 };
 
 template <typename Value, typename pos_int>
-class Backtrace {
+class Backtrace : public Backtrace_Alloc {
  private:
  public:
     size_t count;
     intrusive_ptr<Eval_List<Value> > evaluated;
+#ifdef SAMPLE_BATCH
+    // the samples this node is drawn for, set by sample_filter and
+    // evaluate_batch
+    std::vector<unsigned> batch;
+#endif
     Backtrace()
       : count(0), evaluated(0) {
       }
@@ -74,6 +138,12 @@ class Backtrace {
 
     virtual intrusive_ptr<Eval_List<Value> > eval() = 0;
 
+    // the Backtrace arguments of an algebra function node, i.e. where
+    // --subopt-stream plugs in the alternatives of the sub-problems
+    virtual void subtrees(
+      std::vector<intrusive_ptr<Backtrace<Value, pos_int> > *> &l) {
+    }
+
     // virtual bool is_proxy() const { return false; }
 
     virtual void print(std::ostream &out) { assert(0); }
@@ -83,11 +153,10 @@ class Backtrace {
 template <typename Value, typename pos_int>
 class Backtrace_List : public virtual Backtrace<Value, pos_int> {
  private:
-    // FIXME more efficient version
-    std::list<intrusive_ptr<Backtrace<Value, pos_int> > > list;
+    std::vector<intrusive_ptr<Backtrace<Value, pos_int> > > list;
 
  public:
-    typedef typename std::list<intrusive_ptr<Backtrace<Value,
+    typedef typename std::vector<intrusive_ptr<Backtrace<Value,
       pos_int> > >::iterator iterator;
     iterator begin() { return list.begin(); }
     iterator end() { return list.end(); }
@@ -96,9 +165,46 @@ class Backtrace_List : public virtual Backtrace<Value, pos_int> {
       list.push_back(x);
     }
 
+#ifdef SAMPLE_BATCH
+    // The values of the candidates in sample order. A candidate which was
+    // not drawn by sample_filter (no choice function) stands for all
+    // samples of the list.
+    intrusive_ptr<Eval_List<Value> > eval() {
+      std::vector<unsigned> b =
+        this->batch.empty() ? scil::batch() : this->batch;
+      intrusive_ptr<Eval_List<Value> > all = new Eval_List<Value>();
+      for (typename std::vector<intrusive_ptr< Backtrace<Value,
+        pos_int> > >::iterator i =
+           list.begin();
+           i != list.end(); ++i) {
+        intrusive_ptr<Backtrace<Value, pos_int> > bt = *i;
+        if (bt->batch.empty())
+          bt->batch = b;
+        intrusive_ptr<Eval_List<Value> > elist = bt->eval();
+        erase(bt);
+#ifndef NDEBUG
+        *i = 0;
+#endif
+        for (size_t j = 0; j < elist->size(); ++j)
+          all->push_back(elist->id(j), *(elist->begin() + j));
+        erase(elist);
+      }
+      std::vector<size_t> order(all->size());
+      for (size_t j = 0; j < order.size(); ++j)
+        order[j] = j;
+      std::stable_sort(order.begin(), order.end(),
+          [&all](size_t x, size_t y) { return all->id(x) < all->id(y); });
+      intrusive_ptr<Eval_List<Value> > l = new Eval_List<Value>();
+      for (std::vector<size_t>::iterator j = order.begin(); j != order.end();
+           ++j)
+        l->push_back(all->id(*j), *(all->begin() + *j));
+      erase(all);
+      return l;
+    }
+#else
     intrusive_ptr<Eval_List<Value> > eval() {
       intrusive_ptr<Eval_List<Value> > l = new Eval_List<Value>();
-      for (typename std::list<intrusive_ptr< Backtrace<Value,
+      for (typename std::vector<intrusive_ptr< Backtrace<Value,
         pos_int> > >::iterator i =
            list.begin();
            i != list.end(); ++i) {
@@ -117,6 +223,7 @@ class Backtrace_List : public virtual Backtrace<Value, pos_int> {
       }
       return l;
     }
+#endif
 };
 
 /*
@@ -234,6 +341,28 @@ intrusive_ptr<Eval_List<Value> > evaluate(
 }
 
 
+#ifdef SAMPLE_BATCH
+
+template<typename Value, typename pos_int>
+inline void set_batch(intrusive_ptr<Backtrace<Value, pos_int> > &bt,
+                      const std::vector<unsigned> &b) {
+  bt->batch = b;
+}
+
+// The values of an argument of a --sample-batch node for the samples b of
+// the node, in sample order.
+template<typename Value, typename pos_int>
+inline
+intrusive_ptr<Eval_List<Value> > evaluate_batch(
+  intrusive_ptr<Backtrace<Value, pos_int> > bt,
+  const std::vector<unsigned> &b) {
+  assert(bt);
+  bt->batch = b;
+  return bt->eval();
+}
+
+#endif
+
 template<typename Value>
 inline
 void erase(intrusive_ptr<Eval_List<Value> > &e) {
@@ -372,10 +501,24 @@ class Backtrace_List_Score
     public Backtrace_Score<score_type, Value, pos_int> {
 };
 
+template<typename T, typename = void>
+struct bt_has_less : std::false_type {};
+
+template<typename T>
+struct bt_has_less<T, decltype(void(std::declval<const T&>()
+                                    < std::declval<const T&>()))>
+  : std::true_type {};
+
 template <typename score_type, typename Klass, typename Value, typename pos_int>
-class Backtrace_NT_Back_Base {
+class Backtrace_NT_Back_Base : public Backtrace_Alloc {
  protected:
+    typedef intrusive_ptr<Backtrace_Score<score_type, Value, pos_int> >
+      score_ptr;
+
     intrusive_ptr<Backtrace_List<Value, pos_int> > scores;
+    // the scores, stable sorted by score on the first request - each of
+    // the k fronts of the cell asks for its own score
+    std::vector<score_ptr> index;
 
     Klass *klass;
 
@@ -383,6 +526,47 @@ class Backtrace_NT_Back_Base {
 
     virtual void backtrack() = 0;
 
+    static bool less(const score_ptr &a, const score_ptr &b) {
+      return a->score() < b->score();
+    }
+    static bool below(const score_ptr &a, const score_type &s) {
+      return a->score() < s;
+    }
+
+    void collect(const score_type &score,
+        Backtrace_List_Score<score_type, Value, pos_int> &ret,
+        std::true_type) {
+      if (index.empty()) {
+        for (typename Backtrace_List<Value, pos_int>::iterator i =
+             scores->begin(); i != scores->end(); ++i) {
+          score_ptr bt = boost::dynamic_pointer_cast<
+            Backtrace_Score<score_type, Value, pos_int> >(*i);
+          assert(bt != 0);
+          index.push_back(bt);
+        }
+        std::stable_sort(index.begin(), index.end(), less);
+      }
+      typename std::vector<score_ptr>::iterator i =
+        std::lower_bound(index.begin(), index.end(), score, below);
+      for (; i != index.end() && !(score < (*i)->score()); ++i)
+        ret.push_back(*i);
+    }
+
+    // score types without an order are matched linearly
+    void collect(const score_type &score,
+        Backtrace_List_Score<score_type, Value, pos_int> &ret,
+        std::false_type) {
+      for (typename Backtrace_List<Value, pos_int>::iterator i =
+           scores->begin();
+           i != scores->end(); ++i) {
+        score_ptr bt = boost::dynamic_pointer_cast<
+          Backtrace_Score<score_type, Value, pos_int> >(*i);
+        assert(bt != 0);
+        if (bt->score() == score)
+          ret.push_back(bt);
+      }
+    }
+
  public:
     explicit Backtrace_NT_Back_Base(Klass *klass_)
       : klass(klass_), count(0) {}
@@ -394,16 +578,7 @@ class Backtrace_NT_Back_Base {
       ret = new Backtrace_List_Score<score_type, Value, pos_int>();
       if (scores == 0)
         backtrack();
-      for (typename Backtrace_List<Value, pos_int>::iterator i =
-           scores->begin();
-           i != scores->end(); ++i) {
-        intrusive_ptr<Backtrace_Score<score_type, Value, pos_int> > bt =
-          boost::dynamic_pointer_cast<
-            Backtrace_Score<score_type, Value, pos_int> >(*i);
-        assert(bt != 0);
-        if (bt->score() == score)
-          ret->push_back(bt);
-      }
+      collect(score, *ret, bt_has_less<score_type>());
       ret->setScore(score);
       return ret;
     }
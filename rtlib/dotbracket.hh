@@ -0,0 +1,430 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_DOTBRACKET_HH_
+#define RTLIB_DOTBRACKET_HH_
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <ostream>
+
+#include <boost/cstdint.hpp>
+
+#include "bitops.hh"
+#include "multipool.hh"
+
+// Packed secondary structure strings, the 'dotbracket' answer type of
+// pretty printing algebras.
+//
+// Each position is a 4 bit code of one of the symbols(), i.e. dots,
+// brackets including pseudoknot brackets and the shape symbols. 2 bits
+// would only fit '(', ')' and '.', thus 16 positions share a 64 bit word.
+// The codes follow the ASCII order and 0 marks the end, thus comparing
+// 16 positions at once as unsigned words gives the same order as
+// comparing the strings.
+//
+// A DotBracket is a view (offset, length) into a reference counted
+// buffer. The string is placed in the middle of a new buffer, and the
+// buffer records which range of it is claimed by any view. A view that
+// ends at the claimed range may extend it in place, such that the usual
+// '(' + x + ')' of a pretty printing algebra neither allocates nor
+// copies x, while x itself stays valid. Under OpenMP, only the sole owner
+// of a buffer extends it in place.
+
+class DotBracket {
+ public:
+    enum { BITS = 4, PER_WORD = 16 };
+
+ private:
+    struct Head {
+#ifdef _OPENMP
+      std::atomic<uint32_t> refcount;
+#else
+      uint32_t refcount;
+#endif
+      // claimed range of positions
+      uint32_t lo, hi;
+      uint32_t words;
+
+      Head() : refcount(1), lo(0), hi(0), words(0) {}
+    };
+    enum { HEAD_WORDS = sizeof(Head) / sizeof(uint64_t) };
+    static_assert(sizeof(Head) % sizeof(uint64_t) == 0, "Head padding");
+
+    Head *head;
+    uint32_t off;
+    uint32_t len;
+    bool empty_;
+
+    static MultiPool<uint64_t> &pool() {
+      static MultiPool<uint64_t> p;
+      return p;
+    }
+
+    uint64_t *words() const {
+      return reinterpret_cast<uint64_t*>(head) + HEAD_WORDS;
+    }
+
+    uint32_t capacity() const {
+      return head->words * PER_WORD;
+    }
+
+    // in ASCII order
+    static const char *symbols() {
+      return "()+,-.:<>[]_{|}";
+    }
+
+    static uint64_t code(char c) {
+      const char *r = std::strchr(symbols(), c);
+      assert(c && r);
+      return r - symbols() + 1;
+    }
+
+    static char to_char(uint64_t c) {
+      assert(c && c <= 15);
+      return symbols()[c - 1];
+    }
+
+    uint64_t at(uint32_t i) const {
+      uint32_t p = off + i;
+      return (words()[p / PER_WORD] >> (BITS * (PER_WORD - 1 - p % PER_WORD)))
+        & 0xf;
+    }
+
+    // positions off+i are unclaimed, i.e. still zero
+    void set(uint32_t i, uint64_t c) {
+      uint32_t p = off + i;
+      words()[p / PER_WORD] |= c << (BITS * (PER_WORD - 1 - p % PER_WORD));
+    }
+
+    void release() {
+      if (!head)
+        return;
+      assert(head->refcount > 0);
+      if (!--head->refcount) {
+        uint32_t n = head->words;
+        head->~Head();
+        pool().free(reinterpret_cast<uint64_t*>(head), HEAD_WORDS + n);
+      }
+      head = 0;
+    }
+
+    // copies the view into a new buffer with room for l positions on
+    // the left and r positions on the right
+    void realloc(uint32_t l, uint32_t r) {
+      uint32_t n = len + l + r;
+      uint32_t slack = std::max(n / 2, uint32_t(PER_WORD));
+      uint32_t w = (n + 2 * slack + PER_WORD - 1) / PER_WORD;
+      Head *h = new (pool().malloc(HEAD_WORDS + w)) Head();
+      h->words = w;
+      h->lo = h->hi = (w * PER_WORD - n) / 2 + l;
+      DotBracket t;
+      t.head = h;
+      t.off = h->lo;
+      for (uint32_t i = 0; i < len; ++i)
+        t.set(i, at(i));
+      t.len = len;
+      h->hi += len;
+      release();
+      head = h;
+      off = t.off;
+      t.head = 0;
+    }
+
+    bool sole_owner() const {
+      return head->refcount == 1;
+    }
+
+    // claims n positions behind the view
+    void grow_right(uint32_t n) {
+      if (head && head->hi == off + len && off + len + n <= capacity()
+#ifdef _OPENMP
+          && sole_owner()
+#endif
+          ) {
+        head->hi += n;
+        return;
+      }
+      realloc(0, n);
+      head->hi += n;
+    }
+
+    // claims n positions in front of the view
+    void grow_left(uint32_t n) {
+      if (head && head->lo == off && off >= n
+#ifdef _OPENMP
+          && sole_owner()
+#endif
+          ) {
+        head->lo -= n;
+        off -= n;
+        return;
+      }
+      realloc(n, 0);
+      head->lo -= n;
+      off -= n;
+    }
+
+ public:
+    DotBracket()
+      : head(0), off(0), len(0), empty_(false) {
+    }
+
+    DotBracket(const DotBracket &o)
+      : head(o.head), off(o.off), len(o.len), empty_(o.empty_) {
+      if (head)
+        ++head->refcount;
+    }
+
+    explicit DotBracket(const char *s)
+      : head(0), off(0), len(0), empty_(false) {
+      append(s, std::strlen(s));
+    }
+
+    ~DotBracket() {
+      release();
+    }
+
+    DotBracket &operator=(const DotBracket &o) {
+      if (o.head)
+        ++o.head->refcount;
+      release();
+      head = o.head;
+      off = o.off;
+      len = o.len;
+      empty_ = o.empty_;
+      return *this;
+    }
+
+    void swap(DotBracket &o) {
+      std::swap(head, o.head);
+      std::swap(off, o.off);
+      std::swap(len, o.len);
+      std::swap(empty_, o.empty_);
+    }
+
+    void append(char c, uint32_t n = 1) {
+      empty_ = false;
+      if (!n)
+        return;
+      grow_right(n);
+      uint64_t x = code(c);
+      for (uint32_t i = 0; i < n; ++i)
+        set(len + i, x);
+      len += n;
+    }
+
+    void append(const char *s, uint32_t n) {
+      empty_ = false;
+      if (!n)
+        return;
+      grow_right(n);
+      for (uint32_t i = 0; i < n; ++i)
+        set(len + i, code(s[i]));
+      len += n;
+    }
+
+    void append(const DotBracket &o) {
+      empty_ = false;
+      if (!o.len)
+        return;
+      if (!len) {
+        // share the buffer, e.g. answer = x
+        DotBracket t(o);
+        swap(t);
+        empty_ = false;
+        return;
+      }
+      grow_right(o.len);
+      for (uint32_t i = 0; i < o.len; ++i)
+        set(len + i, o.at(i));
+      len += o.len;
+    }
+
+    void prepend(char c) {
+      empty_ = false;
+      grow_left(1);
+      set(0, code(c));
+      ++len;
+    }
+
+    // 16 positions starting at i, zero padded behind the end
+    uint64_t chunk(uint32_t i) const {
+      assert(i < len);
+      uint32_t p = off + i;
+      uint32_t w = p / PER_WORD, s = p % PER_WORD;
+      uint64_t r = words()[w] << (BITS * s);
+      if (s && w + 1 < head->words)
+        r |= words()[w + 1] >> (BITS * (PER_WORD - s));
+      uint32_t rest = len - i;
+      if (rest < PER_WORD)
+        r &= ~uint64_t(0) << (BITS * (PER_WORD - rest));
+      return r;
+    }
+
+    uint32_t size() const { return len; }
+
+    void empty() {
+      empty_ = true;
+    }
+
+    bool isEmpty() const { return empty_; }
+
+    bool operator==(const DotBracket &o) const {
+      if (len != o.len)
+        return false;
+      if (head == o.head && off == o.off)
+        return true;
+      for (uint32_t i = 0; i < len; i += PER_WORD)
+        if (chunk(i) != o.chunk(i))
+          return false;
+      return true;
+    }
+
+    bool operator!=(const DotBracket &o) const {
+      return !(*this == o);
+    }
+
+    bool operator<(const DotBracket &o) const {
+      for (uint32_t i = 0; i < len && i < o.len; i += PER_WORD) {
+        uint64_t a = chunk(i), b = o.chunk(i);
+        if (a != b)
+          return a < b;
+      }
+      return len < o.len;
+    }
+
+    uint32_t hashable_value() const {
+      hash_to_uint32::djb hash_fn;
+      uint32_t hash = hash_fn.initial();
+      for (uint32_t i = 0; i < len; i += PER_WORD)
+        hash_fn.next(hash, chunk(i));
+      return hash;
+    }
+
+    char operator[](uint32_t i) const {
+      assert(i < len);
+      return to_char(at(i));
+    }
+
+    void put(std::ostream &o) const {
+      char buf[PER_WORD];
+      for (uint32_t i = 0; i < len; i += PER_WORD) {
+        uint64_t c = chunk(i);
+        uint32_t n = std::min(uint32_t(PER_WORD), len - i);
+        for (uint32_t j = 0; j < n; ++j)
+          buf[j] = to_char(c >> (BITS * (PER_WORD - 1 - j)) & 0xf);
+        o.write(buf, n);
+      }
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &o, const DotBracket &d) {
+  d.put(o);
+  return o;
+}
+
+inline void append(DotBracket &d, char c) {
+  d.append(c);
+}
+
+template<typename T>
+inline void append(DotBracket &d, char c, T n) {
+  assert(n >= 0);
+  d.append(c, uint32_t(n));
+}
+
+inline void append(DotBracket &d, const char *s, int n) {
+  d.append(s, n);
+}
+
+inline void append(DotBracket &d, const char *s) {
+  d.append(s, std::strlen(s));
+}
+
+inline void append(DotBracket &d, const DotBracket &x) {
+  d.append(x);
+}
+
+inline void empty(DotBracket &d) {
+  d.empty();
+}
+
+inline bool isEmpty(const DotBracket &d) {
+  return d.isEmpty();
+}
+
+inline uint32_t size(const DotBracket &d) {
+  return d.size();
+}
+
+inline uint32_t hashable_value(const DotBracket &d) {
+  return d.hashable_value();
+}
+
+namespace Hash {
+
+inline uint32_t hashable_value(const DotBracket &d) {
+  return d.hashable_value();
+}
+
+}  // namespace Hash
+
+inline DotBracket operator+(const DotBracket &a, const DotBracket &b) {
+  DotBracket r(a);
+  r.append(b);
+  return r;
+}
+
+inline DotBracket operator+(const DotBracket &a, char c) {
+  DotBracket r(a);
+  r.append(c);
+  return r;
+}
+
+inline DotBracket operator+(char c, const DotBracket &a) {
+  DotBracket r(a);
+  r.prepend(c);
+  return r;
+}
+
+inline DotBracket operator+(const DotBracket &a, const char *s) {
+  DotBracket r(a);
+  r.append(s, std::strlen(s));
+  return r;
+}
+
+inline DotBracket operator+(const char *s, const DotBracket &a) {
+  DotBracket r(s);
+  r.append(a);
+  return r;
+}
+
+inline void swap(DotBracket &a, DotBracket &b) {
+  a.swap(b);
+}
+
+#endif  // RTLIB_DOTBRACKET_HH_
@@ -45,7 +45,13 @@ int main(int argc, char **argv) {
     std::cerr << "Exception: " << e.what() << '\n';
     std::exit(1);
   }
+#if defined(USE_ARENA) && !defined(CHECKPOINTING_INTEGRATED)
+  // all cells live in the per thread arenas, which go away with the
+  // process - skip the teardown of every single table entry
+  gapc::class_name &obj = *new gapc::class_name();
+#else
   gapc::class_name obj;
+#endif
 
   try {
     obj.init(opts);
@@ -71,6 +77,17 @@ int main(int argc, char **argv) {
   std::cout << std::setprecision(FLOAT_ACC) << std::fixed;
 #endif
 
+#ifdef USE_GSL
+#ifdef SAMPLE_BATCH
+  scil::streams() = true;
+  uint64_t seed = opts.seed ? opts.seed : scil::default_seed();
+#else
+  // per sample streams only with --seed
+  scil::streams() = opts.seed != 0;
+  uint64_t seed = opts.seed;
+#endif
+#endif
+
   // print statements prior to result list, e.g. for TikZ document generation
   obj.print_document_header(std::cout);
 #ifdef WINDOW_MODE
@@ -81,8 +98,20 @@ int main(int argc, char **argv) {
     std::cout << "Answer ("
       << i << ", " << right << ") :\n";
     obj.print_result(std::cout, res);
+#if defined(SAMPLE_BATCH)
+    scil::draw_batch(std::cout, opts.repeats, seed,
+                     [&](std::ostream &out) {
+                       obj.print_backtrack(out, res);
+                     });
+#elif defined(USE_GSL)
+    scil::draw_samples(std::cout, opts.repeats, seed,
+                       [&](std::ostream &out) {
+                         obj.print_backtrack(out, res);
+                       });
+#else
     for (unsigned int j = 0; j < opts.repeats; ++j)
       obj.print_backtrack(std::cout, res);
+#endif
     if (i+opts.window_size >= n)
       break;
     obj.window_increment();
@@ -108,8 +137,20 @@ int main(int argc, char **argv) {
 #ifdef TRACE
   std::cerr << "start backtrack\n";
 #endif
+#if defined(SAMPLE_BATCH)
+  scil::draw_batch(std::cout, opts.repeats, seed,
+                   [&](std::ostream &out) {
+                     obj.print_backtrack(out, res);
+                   });
+#elif defined(USE_GSL)
+  scil::draw_samples(std::cout, opts.repeats, seed,
+                     [&](std::ostream &out) {
+                       obj.print_backtrack(out, res);
+                     });
+#else
   for (unsigned int i = 0; i < opts.repeats; ++i)
     obj.print_backtrack(std::cout, res);
+#endif
   obj.print_subopt(std::cout, opts.delta);
 
   gapc::add_event("end");
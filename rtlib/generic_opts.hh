@@ -110,6 +110,13 @@ class Opts {
     unsigned int delta;
     unsigned int repeats;
     unsigned k;
+#ifdef PARETO_EPS
+    double pareto_eps;
+#endif
+#ifdef USE_GSL
+    // seed of the per sample streams, 0: one gsl_rng_default stream
+    unsigned long seed;
+#endif
 
 #ifdef CHECKPOINTING_INTEGRATED
     size_t checkpoint_interval;  // default interval: 3600s (1h)
@@ -134,6 +141,12 @@ class Opts {
       delta(0),
       repeats(1),
       k(3),
+#ifdef PARETO_EPS
+      pareto_eps(0.01),
+#endif
+#ifdef USE_GSL
+      seed(0),
+#endif
 #ifdef CHECKPOINTING_INTEGRATED
       checkpoint_interval(DEFAULT_CHECKPOINT_INTERVAL),
       checkpoint_out_path(boost::filesystem::current_path()),
@@ -200,6 +213,21 @@ class Opts {
         << "                                      after the program finished "
         << "its calculations\n"
 #endif
+#ifdef PARETO_EPS
+        << "--paretoEpsilon,-e       E            keep a (1+E)-approximate "
+        << "Pareto front\n"
+        << "                                      (default: 0.01, 0: exact)\n"
+#endif
+#ifdef USE_GSL
+        << "--seed,-S                N            draw sample i of the "
+        << "stochastic backtracing\n"
+        << "                                      from Philox stream (N, i), "
+        << "i.e. the same\n"
+        << "                                      samples for any number of "
+        << "threads\n"
+        << "                                      (default: one "
+        << "gsl_rng_default stream)\n"
+#endif
 #ifdef _OPENMP
         << "--tileSize,-L            N            set tile size in "
         << "multithreaded cyk \n"
@@ -223,6 +251,12 @@ class Opts {
             {"checkpointInput", required_argument, nullptr, 'I'},
             {"keepArchives", no_argument, nullptr, 'K'},
             {"tileSize", required_argument, nullptr, 'L'},
+#ifdef PARETO_EPS
+            {"paretoEpsilon", required_argument, nullptr, 'e'},
+#endif
+#ifdef USE_GSL
+            {"seed", required_argument, nullptr, 'S'},
+#endif
             {nullptr, no_argument, nullptr, 0}};
       this->argc = argc;
       this->argv = argv;
@@ -242,6 +276,12 @@ class Opts {
 #endif
 #ifdef _OPENMP
              "L:"
+#endif
+#ifdef PARETO_EPS
+             "e:"
+#endif
+#ifdef USE_GSL
+             "S:"
 #endif
              "hd:r:k:H:", long_opts, nullptr)) != -1) {
         switch (o) {
@@ -371,6 +411,18 @@ class Opts {
           case 'L' :
             tile_size = std::atoi(optarg);
             break;
+#endif
+#ifdef USE_GSL
+          case 'S' :
+            seed = std::strtoul(optarg, 0, 10);
+            break;
+#endif
+#ifdef PARETO_EPS
+          case 'e' :
+            pareto_eps = std::atof(optarg);
+            if (pareto_eps < 0)
+              throw OptException("Epsilon cannot be < 0.");
+            break;
 #endif
           case '?' :
           case ':' :
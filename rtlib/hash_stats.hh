@@ -26,6 +26,14 @@
 
 #include <algorithm>
 
+#ifdef HASH_ADAPTIVE
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#endif
+
 // workaround Sun CC 12 Segmentation fault
 #if defined(__SUNPRO_CC) && __SUNPRO_CC <= 0x5100
 #warning Because of a Sun CC compiler bug, the hash-table STAT-code is disabled
@@ -130,6 +138,109 @@ struct NoStats {
   double collisions() const { return 23; }
 };
 
+#ifdef HASH_ADAPTIVE
+// Learns the number of classes of the classifying choice functions per
+// non-terminal and subword length, such that a new Set is allocated with
+// the right size at once instead of growing through HASH_INITIAL,
+// 2*HASH_INITIAL, ... via repeated rehashes.
+//
+// Lengths up to LINEAR are tracked exactly, longer ones in powers of two.
+// Each slot holds a moving average of the recorded sizes; concurrent
+// updates (OpenMP CYK) may lose samples, which just delays the learning.
+//
+// If the environment variable GAPC_HASH_SIZES names a file, the learned
+// sizes are read from it at startup and written back at exit, i.e. the
+// next run of the same binary starts with pre-sized tables.
+class Size_Stats {
+ public:
+    enum { NTS = 256, LINEAR = 128, BUCKETS = LINEAR + 32 };
+
+ private:
+    std::unique_ptr<std::atomic<uint32_t>[]> sizes;
+    const char *file;
+
+    Size_Stats(const Size_Stats&);
+    Size_Stats &operator=(const Size_Stats&);
+
+    static size_t bucket(size_t len) {
+      if (len < LINEAR)
+        return len;
+      size_t r = LINEAR;
+      for (len /= LINEAR; len > 1 && r + 1 < BUCKETS; len /= 2)
+        ++r;
+      return r;
+    }
+
+    std::atomic<uint32_t> *slot(unsigned nt, size_t len) const {
+      if (nt >= NTS)
+        return 0;
+      return &sizes[nt * BUCKETS + bucket(len)];
+    }
+
+    void load() {
+      std::ifstream in(file);
+      size_t i;
+      uint32_t n;
+      while (in >> i >> n)
+        if (i < size_t(NTS) * BUCKETS)
+          sizes[i].store(n, std::memory_order_relaxed);
+    }
+
+    void save() const {
+      std::ofstream out(file);
+      for (size_t i = 0; i < size_t(NTS) * BUCKETS; ++i) {
+        uint32_t n = sizes[i].load(std::memory_order_relaxed);
+        if (n)
+          out << i << ' ' << n << '\n';
+      }
+    }
+
+ public:
+    Size_Stats()
+      : sizes(new std::atomic<uint32_t>[size_t(NTS) * BUCKETS]),
+        file(std::getenv("GAPC_HASH_SIZES")) {
+      for (size_t i = 0; i < size_t(NTS) * BUCKETS; ++i)
+        sizes[i].store(0, std::memory_order_relaxed);
+      if (file)
+        load();
+    }
+
+    ~Size_Stats() {
+      if (file)
+        save();
+    }
+
+    static Size_Stats &instance() {
+      static Size_Stats s;
+      return s;
+    }
+
+    // expected number of classes, 0 if nothing is known yet
+    uint32_t hint(unsigned nt, size_t len) const {
+      std::atomic<uint32_t> *s = slot(nt, len);
+      if (!s)
+        return 0;
+      return s->load(std::memory_order_relaxed);
+    }
+
+    void record(unsigned nt, size_t len, uint32_t n) {
+      std::atomic<uint32_t> *s = slot(nt, len);
+      if (!s)
+        return;
+      uint32_t old = s->load(std::memory_order_relaxed);
+      // moves a quarter of the distance, but at least one step, i.e. a
+      // constant size is reached exactly
+      if (!old)
+        old = n;
+      else if (n > old)
+        old += (n - old + 3) / 4;
+      else
+        old -= (old - n + 3) / 4;
+      s->store(old, std::memory_order_relaxed);
+    }
+};
+#endif
+
 #ifdef STATS
 inline std::ostream &operator<<(std::ostream &o, const Stats &stats) {
   stats.put(o);
@@ -0,0 +1,283 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_HASH_SWISS_HH_
+#define RTLIB_HASH_SWISS_HH_
+
+#include <cassert>
+#include <algorithm>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "bitops.hh"
+#include "pool.hh"
+
+// Open addressing hash set with control bytes (Swiss table), selected as
+// backend of Hash::Ref by HASH_SWISS (gapc --swiss-hash).
+//
+// The items are stored densely in insertion order together with their
+// 64 bit hash, thus a rehash never calls the (shape) hash function of the
+// inspector again. The index consists of one control byte per slot - empty
+// or the low 7 bits of the hash - and is probed in groups of 16 slots: one
+// SSE2 compare yields all slots of a group whose control byte matches, and
+// only those items are compared with Inspector::equal.
+
+namespace Hash {
+
+struct Swiss_Group {
+  enum { SIZE = 16, EMPTY = -128 };
+
+  // bit i is set, if control byte i of the group equals b
+  static uint32_t match(const int8_t *g, int8_t b) {
+#if defined(__SSE2__)
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8(b)));
+#else
+    uint32_t r = 0;
+    for (int i = 0; i < SIZE; ++i)
+      r |= uint32_t(g[i] == b) << i;
+    return r;
+#endif
+  }
+};
+
+template <typename T, class Inspector, typename U = uint32_t>
+class Swiss_Set {
+ private:
+    std::vector<T> items;
+    std::vector<uint64_t> hashes;
+    std::vector<int8_t> ctrl;
+    std::vector<U> slots;
+    U mask;
+#ifndef NDEBUG
+    bool finalized;
+#endif
+
+    Inspector inspector;
+
+#ifdef HASH_INITIAL
+    enum { INITIAL = HASH_INITIAL };
+#else
+    enum { INITIAL = 16 };
+#endif
+
+    static uint64_t mix(uint64_t h) {
+      h ^= h >> 30;
+      h *= 0xbf58476d1ce4e5b9ULL;
+      h ^= h >> 27;
+      h *= 0x94d049bb133111ebULL;
+      return h ^ (h >> 31);
+    }
+
+    static U slot(uint32_t m) {
+      return find_first_set(m) - 1;
+    }
+
+    // triangular probing visits every group of a power of 2 sized table
+    void place(U item, uint64_t h) {
+      for (U g = (h >> 7) & mask, step = 1; ; g = (g + step++) & mask) {
+        int8_t *c = &ctrl[g * Swiss_Group::SIZE];
+        uint32_t e = Swiss_Group::match(c, Swiss_Group::EMPTY);
+        if (e) {
+          U s = slot(e);
+          c[s] = h & 0x7f;
+          slots[g * Swiss_Group::SIZE + s] = item;
+          return;
+        }
+      }
+    }
+
+    void rehash(U groups) {
+      assert(groups == size_to_next_power(groups));
+      ctrl.assign(groups * Swiss_Group::SIZE, Swiss_Group::EMPTY);
+      slots.resize(groups * Swiss_Group::SIZE);
+      mask = groups - 1;
+      for (U i = 0; i < items.size(); ++i)
+        place(i, hashes[i]);
+    }
+
+    // keeps the items with keep[i] in their order
+    void compact(const std::vector<bool> &keep) {
+      U j = 0;
+      for (U i = 0; i < items.size(); ++i)
+        if (keep[i]) {
+          if (i != j) {
+            items[j] = items[i];
+            hashes[j] = hashes[i];
+          }
+          ++j;
+        }
+      items.erase(items.begin() + j, items.end());
+      hashes.resize(j);
+    }
+
+    Swiss_Set(const Swiss_Set&);
+    Swiss_Set &operator=(const Swiss_Set&);
+
+ public:
+    U ref_count;
+    Swiss_Set()
+      : mask(0),
+#ifndef NDEBUG
+        finalized(false),
+#endif
+        ref_count(1) {
+    }
+
+    void resize(U i) {
+      U groups = size_to_next_power(i / 7 * 8 / Swiss_Group::SIZE + 1);
+      if (groups * Swiss_Group::SIZE > ctrl.size())
+        rehash(groups);
+    }
+
+    void add(const T &t) {
+      assert(!finalized);
+      // load factor 7/8
+      if ((items.size() + 1) * 8 > ctrl.size() * 7)
+        rehash(ctrl.empty() ? size_to_next_power(
+            U(INITIAL / Swiss_Group::SIZE + 1))
+          : U(2 * (mask + 1)));
+      uint64_t h = mix(inspector.hash(t));
+      int8_t h2 = h & 0x7f;
+      for (U g = (h >> 7) & mask, step = 1; ; g = (g + step++) & mask) {
+        int8_t *c = &ctrl[g * Swiss_Group::SIZE];
+        for (uint32_t m = Swiss_Group::match(c, h2); m; m &= m - 1) {
+          T &x = items[slots[g * Swiss_Group::SIZE + slot(m)]];
+          if (inspector.equal(x, t)) {
+            inspector.update(x, t);
+            return;
+          }
+        }
+        uint32_t e = Swiss_Group::match(c, Swiss_Group::EMPTY);
+        if (e) {
+          U s = slot(e);
+          c[s] = h2;
+          slots[g * Swiss_Group::SIZE + s] = items.size();
+          items.push_back(inspector.init(t));
+          hashes.push_back(h);
+          return;
+        }
+      }
+    }
+
+    void reserve(U n) {
+      resize(n);
+      items.reserve(n);
+      hashes.reserve(n);
+    }
+
+    bool isEmpty() const { return items.empty(); }
+    U size() const { return items.size(); }
+
+    typedef typename std::vector<T>::iterator iterator;
+
+    iterator begin() { assert(finalized); return items.begin(); }
+    iterator end() { return items.end(); }
+
+    // same semantics as Set::filter()
+    void filter() {
+      if (isEmpty())
+        return;
+
+      if (inspector.filter()) {
+        std::vector<bool> keep(items.size());
+        for (U i = 0; i < items.size(); ++i)
+          keep[i] = !inspector.filter(items[i]);
+        compact(keep);
+      }
+
+      if (inspector.cutoff()) {
+        std::vector<U> order(items.size());
+        for (U i = 0; i < order.size(); ++i)
+          order[i] = i;
+        typename Inspector::compare cmp;
+        std::sort(order.begin(), order.end(),
+                  [this, &cmp](U a, U b) { return cmp(items[a], items[b]); });
+        U newend = order.empty() ? 0 : 1;
+        U uniques = 1;
+        U k = inspector.k();
+        if (uniques < k)
+          for (U i = 1; i < order.size(); ++i) {
+            if (!inspector.equal_score(items[order[i-1]], items[order[i]]))
+              ++uniques;
+            if (uniques > k)
+              break;
+            ++newend;
+          }
+        std::vector<T> a;
+        std::vector<uint64_t> b;
+        a.reserve(newend);
+        b.reserve(newend);
+        for (U i = 0; i < newend; ++i) {
+          a.push_back(items[order[i]]);
+          b.push_back(hashes[order[i]]);
+        }
+        items.swap(a);
+        hashes.swap(b);
+      }
+
+      rehash(mask + 1);
+    }
+
+    void finalize() {
+#ifndef NDEBUG
+      assert(!finalized);
+      finalized = true;
+#endif
+      for (iterator i = items.begin(); i != items.end(); ++i)
+        inspector.finalize(*i);
+    }
+
+    void *operator new(size_t t) noexcept(false);
+    void operator delete(void *b) noexcept(false);
+};
+
+template <typename T, class Inspector, typename U>
+struct Swiss_Set_Dummy {
+  static Pool<Swiss_Set<T, Inspector, U> > pool;
+};
+
+template <typename T, class Inspector, typename U>
+Pool<Swiss_Set<T, Inspector, U> > Swiss_Set_Dummy<T, Inspector, U>::pool;
+
+template <typename T, class Inspector, typename U>
+void *Swiss_Set<T, Inspector, U>::operator new(size_t t) noexcept(false) {
+  assert(sizeof(Swiss_Set<T, Inspector, U>) == t);
+  return Swiss_Set_Dummy<T, Inspector, U>::pool.malloc();
+}
+
+template <typename T, class Inspector, typename U>
+void Swiss_Set<T, Inspector, U>::operator delete(void *b) noexcept(false) {
+  if (!b)
+    return;
+  Swiss_Set_Dummy<T, Inspector, U>::pool.free(
+      static_cast<Swiss_Set<T, Inspector, U>*>(b));
+}
+
+}  // namespace Hash
+
+#endif  // RTLIB_HASH_SWISS_HH_
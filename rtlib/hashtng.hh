@@ -45,6 +45,10 @@
 
 #include "hash_stats.hh"
 
+#if defined(HASH_SWISS) && defined(CHECKPOINTING_INTEGRATED)
+#error "The Swiss table hash backend does not support checkpointing."
+#endif
+
 #if defined(CHECKPOINTING_INTEGRATED)
 // serialization headers for the checkpointing of Hash_Ref objects
 // (will be included in generated code through rtlib/adp.hh)
@@ -279,10 +283,17 @@ class Set {
         return;
       rehash(i);
     }
+    // allocate room for n elements below the load factor
+    void reserve(U n) {
+      U i = n * 100 / load_factor + 1;
+      if (i > array.size())
+        rehash(i);
+    }
     void add(const T &t) {
       add(t, true);
     }
     bool isEmpty() const { return !used_; }
+    U size() const { return used_; }
 
     typedef typename Vector_Sparse<T, U>::iterator iterator;
 
@@ -410,8 +421,22 @@ void Set<SET_TEMPLATE_ARGS>::operator delete(void *b) noexcept(false) {
       static_cast<Set<SET_TEMPLATE_ARGS>*>(b));
 }
 
+#undef SET_TEMPLATE_DECL
+#undef SET_TEMPLATE_ARGS
+
+}  // namespace Hash
+
+#ifdef HASH_SWISS
+#include "hash_swiss.hh"
+#define HASH_REF_SET Swiss_Set
+#else
+#define HASH_REF_SET Set
+#endif
+
+namespace Hash {
+
 template<class T, class I>
-class Ref : public ::Ref::Lazy<Set<T, I> > {
+class Ref : public ::Ref::Lazy<HASH_REF_SET<T, I> > {
  private:
 #if defined(CHECKPOINTING_INTEGRATED)
   friend class boost::serialization::access;
@@ -428,8 +453,7 @@ class Ref : public ::Ref::Lazy<Set<T, I> > {
  public:
 };
 
-#undef SET_TEMPLATE_DECL
-#undef SET_TEMPLATE_ARGS
+#undef HASH_REF_SET
 
 }  // namespace Hash
 
@@ -480,6 +504,22 @@ inline bool isEmpty(const Hash::Ref<T, I> &x) {
   return !x.l || x.const_ref().isEmpty();
 }
 
+#ifdef HASH_ADAPTIVE
+// nt and len identify the table cell, see Hash::Size_Stats
+template<class T, class I>
+inline void hash_hint(Hash::Ref<T, I> &x, unsigned nt, size_t len) {
+  uint32_t n = Hash::Size_Stats::instance().hint(nt, len);
+  if (n)
+    x->reserve(n);
+}
+
+template<class T, class I>
+inline void hash_filter(Hash::Ref<T, I> &x, unsigned nt, size_t len) {
+  Hash::Size_Stats::instance().record(nt, len, isEmpty(x) ? 0 : x->size());
+  hash_filter(x);
+}
+#endif
+
 template<class T, class I>
 inline void erase(Hash::Ref<T, I> &x) {
 }
@@ -26,6 +26,7 @@
 #define RTLIB_MULTIPOOL_HH_
 
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 
 #include <vector>
@@ -33,6 +34,7 @@
 // tr1 has it
 #include <boost/cstdint.hpp>
 
+#include "arena.hh"
 #include "map_pool.hh"
 
 template <class K>
@@ -41,7 +43,7 @@ class MultiPool {
     typedef Map::Pool<K> pool_t;
 
     std::vector<pool_t*> pools;
-#ifndef NDEBUG
+#if !defined(NDEBUG) && !defined(_OPENMP)
     size_t max_n;
 #endif
 
@@ -59,12 +61,14 @@ class MultiPool {
 
  public:
     MultiPool()
-#ifndef NDEBUG
+#if !defined(NDEBUG) && !defined(_OPENMP)
       : max_n(0)
 #endif
     {
+#if !defined(USE_ARENA) && !defined(USE_SYSTEM_MALLOC)
       pools.resize(1);
       pools[0] = new pool_t(1);
+#endif
     }
 
     ~MultiPool() {
@@ -79,14 +83,20 @@ class MultiPool {
 
     K * malloc(size_t n) {
       assert(n);
-#ifndef NDEBUG
+#if !defined(NDEBUG) && !defined(_OPENMP)
       if (n > max_n) {
         max_n = n;
         // std::cerr << "MAX N: " << max_n << '\n';
       }
 #endif
+#if defined(USE_ARENA)
+      K *r = static_cast<K*>(Arena::local().malloc(sizeof(K)*n));
+#elif defined(USE_SYSTEM_MALLOC)
+      K *r = static_cast<K*>(std::malloc(sizeof(K)*n));
+#else
       extend(n);
       K *r = pools[n-1]->malloc();
+#endif
       assert(r);
       std::memset(r, 0, sizeof(K)*n);
       return r;
@@ -94,8 +104,14 @@ class MultiPool {
 
     void free(K *x, size_t n) {
       assert(x);
+#if defined(USE_ARENA)
+      Arena::local().free(x, sizeof(K)*n);
+#elif defined(USE_SYSTEM_MALLOC)
+      std::free(x);
+#else
       assert(n <= pools.size());
       pools[n-1]->free(x);
+#endif
     }
 };
 
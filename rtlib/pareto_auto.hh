@@ -0,0 +1,256 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_PARETO_AUTO_HH_
+#define RTLIB_PARETO_AUTO_HH_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+#include "list.hh"
+#include "pareto_dom_sort.hh"
+#include "pareto_parallel.hh"
+
+// Automatic selection of the Pareto front implementation (-P 7).
+//
+// All variants are compiled into the binary and use the same comparator.
+// The first calls with at least PARETO_AUTO_MIN candidates - i.e. the
+// first non-trivial cells - are distributed round robin over the
+// variants and timed. After PARETO_AUTO_SAMPLES timed calls per variant,
+// the variant with the least time per candidate is used for the rest of
+// the run and reported on stderr. Smaller candidate lists always use the
+// domination sort.
+//
+// The variants agree on the front, but not on its order and not on which
+// of several candidates with equal objectives survives. Thus, the front is
+// normalised afterwards: sorted by its objectives and, per objective
+// vector, represented by the first such candidate of the input. The output
+// does not depend on the timings.
+
+#ifndef PARETO_AUTO_MIN
+#define PARETO_AUTO_MIN 64
+#endif
+
+#ifndef PARETO_AUTO_SAMPLES
+#define PARETO_AUTO_SAMPLES 8
+#endif
+
+class Pareto_Auto {
+ public:
+    enum Variant { DOM_SORT, SPLIT_MERGE, PARALLEL, VARIANTS };
+
+ private:
+    std::atomic<int> choice;
+    std::mutex mutex;
+    unsigned next;
+    unsigned samples[VARIANTS];
+    unsigned recorded[VARIANTS];
+    double time[VARIANTS];
+    double candidates[VARIANTS];
+
+    Pareto_Auto() : choice(-1), next(0) {
+      for (int i = 0; i < VARIANTS; ++i) {
+        samples[i] = 0;
+        recorded[i] = 0;
+        time[i] = 0;
+        candidates[i] = 0;
+      }
+      // a parallel merge does not pay off on a single thread
+      if (pareto_parallel_threads() < 2) {
+        samples[PARALLEL] = PARETO_AUTO_SAMPLES;
+        recorded[PARALLEL] = PARETO_AUTO_SAMPLES;
+      }
+    }
+
+    static const char *name(int v) {
+      switch (v) {
+        case DOM_SORT: return "domination sort";
+        case SPLIT_MERGE: return "divide and conquer";
+        case PARALLEL: return "parallel divide and conquer";
+      }
+      return "";
+    }
+
+    // called with locked mutex
+    void decide() {
+      int best = DOM_SORT;
+      for (int i = 0; i < VARIANTS; ++i) {
+        if (candidates[i] > 0 && (candidates[best] == 0 ||
+            time[i] / candidates[i] < time[best] / candidates[best])) {
+          best = i;
+        }
+      }
+      std::cerr << "Pareto front: using " << name(best);
+      if (candidates[best] > 0) {
+        std::cerr << " (" << 1e9 * time[best] / candidates[best]
+                  << " ns per candidate)";
+      }
+      std::cerr << '\n';
+      choice = best;
+    }
+
+ public:
+    static Pareto_Auto &instance() {
+      static Pareto_Auto p;
+      return p;
+    }
+
+    // sample: the call has to be timed and recorded
+    int select(size_t n, bool &sample) {
+      sample = false;
+      int c = choice;
+      if (c >= 0) {
+        return c;
+      }
+      if (n < PARETO_AUTO_MIN) {
+        return DOM_SORT;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      if (choice >= 0) {
+        return choice;
+      }
+      for (int i = 0; i < VARIANTS; ++i) {
+        c = (next + i) % VARIANTS;
+        if (samples[c] < PARETO_AUTO_SAMPLES) {
+          ++samples[c];
+          next = (c + 1) % VARIANTS;
+          sample = true;
+          return c;
+        }
+      }
+      // all samples handed out, some are still running
+      return DOM_SORT;
+    }
+
+    void record(int v, size_t n, double seconds) {
+      std::lock_guard<std::mutex> lock(mutex);
+      time[v] += seconds;
+      candidates[v] += n;
+      ++recorded[v];
+      if (choice >= 0) {
+        return;
+      }
+      // not before the last timing arrived
+      for (int i = 0; i < VARIANTS; ++i) {
+        if (recorded[i] < PARETO_AUTO_SAMPLES) {
+          return;
+        }
+      }
+      decide();
+    }
+};
+
+// lexicographic order of the objectives, better first
+template<typename Compare>
+struct Pareto_Objective_Less {
+  Compare &c;
+  explicit Pareto_Objective_Less(Compare &x) : c(x) {}
+  template<class T>
+  bool operator()(const T &a, const T &b) const {
+    for (int i = 1; i <= c.dim; ++i) {
+      int r = c(a, b, i);
+      if (r) {
+        return r > 0;
+      }
+    }
+    return false;
+  }
+};
+
+template<class T, typename Iterator, typename Compare>
+void pareto_normalize(List_Ref<T> &answers, std::vector<T> &front,
+                      Iterator begin, Iterator end, Compare &c) {
+  Pareto_Objective_Less<Compare> less(c);
+  std::sort(front.begin(), front.end(), less);
+  typename std::vector<T>::iterator last = front.begin();
+  for (typename std::vector<T>::iterator i = front.begin(); i != front.end();
+       ++i) {
+    if (i == front.begin() || less(*(last - 1), *i)) {
+      *last++ = *i;
+    }
+  }
+  front.erase(last, front.end());
+
+  std::vector<bool> taken(front.size(), false);
+  size_t left = front.size();
+  for (Iterator i = begin; i != end && left; ++i) {
+    typename std::vector<T>::iterator j =
+      std::lower_bound(front.begin(), front.end(), *i, less);
+    if (j == front.end() || less(*i, *j) || taken[j - front.begin()]) {
+      continue;
+    }
+    *j = *i;
+    taken[j - front.begin()] = true;
+    --left;
+  }
+  for (typename std::vector<T>::iterator i = front.begin(); i != front.end();
+       ++i) {
+    answers.ref().push_back(*i);
+  }
+}
+
+template<class T, typename Iterator, typename Compare>
+void pareto_auto(
+  List_Ref<T> &answers, Iterator begin, Iterator end, Compare &c) {
+  const size_t n = std::distance(begin, end);
+  bool sample;
+  int v = Pareto_Auto::instance().select(n, sample);
+  std::chrono::steady_clock::time_point start;
+  if (sample) {
+    start = std::chrono::steady_clock::now();
+  }
+
+  std::vector<T> r;
+  if (v == Pareto_Auto::DOM_SORT) {
+    List_Ref<T> f;
+    pareto_domination_sort(f, begin, end, c);
+    if (!isEmpty(f)) {
+      r.assign(f.ref().begin(), f.ref().end());
+    }
+  } else {
+    size_t parts = n / 256 + 1;
+    const size_t threads = pareto_parallel_threads();
+    if (v == Pareto_Auto::PARALLEL) {
+      if (parts < 2) {
+        parts = 2;
+      }
+      if (parts > 2 * threads) {
+        parts = 2 * threads;
+      }
+    }
+    pareto_split_merge(r, begin, end, c, parts, v == Pareto_Auto::PARALLEL);
+  }
+
+  if (sample) {
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+    Pareto_Auto::instance().record(v, n, d.count());
+  }
+  pareto_normalize(answers, r, begin, end, c);
+}
+
+#endif  // RTLIB_PARETO_AUTO_HH_
@@ -27,10 +27,13 @@
 #ifndef RTLIB_PARETO_DOM_SORT_HH_
 #define RTLIB_PARETO_DOM_SORT_HH_
 
+#include "pareto_packed.hh"
+
 
 template<class T, typename Iterator, typename Compare>
 void pareto_domination_sort(
-  List_Ref<T> &answers, Iterator begin, Iterator end, Compare &c) {
+  List_Ref<T> &answers, Iterator begin, Iterator end, Compare &c,
+  std::false_type) {
   if (begin == end) {
     return;
   }
@@ -157,7 +160,67 @@ void pareto_domination_sort(
   }
 }
 
+// same candidate order and result as above, but the dominance checks run
+// over the packed keys of the current front
+template<class T, typename Iterator, typename Compare>
+void pareto_domination_sort(
+  List_Ref<T> &answers, Iterator begin, Iterator end, Compare &c,
+  std::true_type) {
+  if (begin == end) {
+    return;
+  }
+
+  Pareto_Front<T, Compare::dim> front;
+  double k[Compare::dim];
+  for (typename List_Ref<T>::iterator answer = answers.ref().begin();
+       answer != answers.ref().end(); ++answer) {
+    c.keys(*answer, *answer, k);
+    front.push_back(*answer, k);
+  }
 
+  Iterator m1 = begin;
+  std::advance(m1, std::distance(begin, end) / 2);
+  Iterator m2 = m1;
+
+  bool left = m2 != begin;
+  bool right = true;
+
+  while (left || right) {
+    if (left) {
+      --m2;
+      c.keys(*m2, *m2, k);
+      if (!front.dominates(k)) {
+        front.erase_covered(k);
+        front.push_back(*m2, k);
+      }
+      if (m2 == begin) {
+        left = false;
+      }
+    }
+    if (right) {
+      c.keys(*m1, *m1, k);
+      if (!front.dominates(k)) {
+        front.erase_covered(k);
+        front.push_back(*m1, k);
+      }
+      ++m1;
+      if (m1 == end) {
+        right = false;
+      }
+    }
+  }
+
+  answers.ref().clear();
+  answers.ref().insert(answers.ref().end(),
+                       front.items().begin(), front.items().end());
+}
+
+template<class T, typename Iterator, typename Compare>
+inline void pareto_domination_sort(
+  List_Ref<T> &answers, Iterator begin, Iterator end, Compare &c) {
+  pareto_domination_sort(answers, begin, end, c,
+                         typename Pareto_Has_Keys<Compare>::type());
+}
 
 
 #endif  // RTLIB_PARETO_DOM_SORT_HH_
@@ -0,0 +1,153 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_PARETO_EPS_HH_
+#define RTLIB_PARETO_EPS_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "list.hh"
+#include "pareto_packed.hh"
+#include "pareto_dom_sort.hh"
+
+// epsilon-Pareto front (-P 6), epsilon is set at runtime (-e).
+//
+// The key of every dimension (see pareto_packed.hh) is mapped to a box
+// index, where the boxes grow geometrically by (1 + epsilon) with the
+// distance from 0. The front keeps at most one candidate per box and no
+// candidate whose box is dominated by another box (Laumanns et al.).
+// Thus, every candidate of the input is (1 + epsilon)-dominated -
+// relative to 1 + |value| - by a member of the result, and the result size
+// is bounded by the number of boxes instead of by the input.
+
+struct Pareto_Eps {
+  static double &value() {
+    static double eps = 0.01;
+    return eps;
+  }
+  static void set(double eps) {
+    value() = eps;
+  }
+};
+
+// l = log1p(epsilon), monotone in k
+inline double pareto_eps_box(double k, double l) {
+  if (k >= 0) {
+    return std::floor(std::log1p(k) / l);
+  }
+  return -std::floor(std::log1p(-k) / l) - 1;
+}
+
+// without packed keys (non-numeric dimensions) the front is exact
+template<class T, typename Iterator, typename Compare>
+inline void pareto_eps(
+  List_Ref<T> &answers, Iterator begin, Iterator end, Compare &c,
+  std::false_type) {
+  pareto_domination_sort(answers, begin, end, c);
+}
+
+template<class T, typename Iterator, typename Compare>
+void pareto_eps(
+  List_Ref<T> &answers, Iterator begin, Iterator end, Compare &c,
+  std::true_type) {
+  const double eps = Pareto_Eps::value();
+  if (eps <= 0) {
+    pareto_domination_sort(answers, begin, end, c);
+    return;
+  }
+  const double l = std::log1p(eps);
+  const int D = Compare::dim;
+
+  std::vector<T> items;
+  // D keys, then D box indices per member
+  std::vector<double> keys;
+  double k[2 * D];
+  for (Iterator x = begin; x != end; ++x) {
+    c.keys(*x, *x, k);
+    for (int d = 0; d < D; ++d) {
+      k[D + d] = pareto_eps_box(k[d], l);
+    }
+
+    bool add = true;
+    for (size_t j = 0; add && j < items.size(); ++j) {
+      const double *m = &keys[2 * D * j];
+      bool le = true;
+      bool eq = true;
+      for (int d = D; d < 2 * D; ++d) {
+        le = le && m[d] <= k[d];
+        eq = eq && m[d] == k[d];
+      }
+      if (eq) {
+        // same box: replace the member only if x dominates it
+        bool better = true;
+        for (int d = 0; d < D; ++d) {
+          better = better && k[d] <= m[d];
+        }
+        add = better;
+      } else {
+        add = !le;
+      }
+    }
+    if (!add) {
+      continue;
+    }
+
+    size_t o = 0;
+    for (size_t j = 0; j < items.size(); ++j) {
+      const double *m = &keys[2 * D * j];
+      bool ge = true;
+      for (int d = D; d < 2 * D; ++d) {
+        ge = ge && m[d] >= k[d];
+      }
+      if (ge) {
+        continue;
+      }
+      if (o != j) {
+        items[o] = items[j];
+        std::copy(m, m + 2 * D, &keys[2 * D * o]);
+      }
+      ++o;
+    }
+    items.resize(o);
+    keys.resize(2 * D * o);
+    items.push_back(*x);
+    keys.insert(keys.end(), k, k + 2 * D);
+  }
+
+  for (typename std::vector<T>::iterator i = items.begin(); i != items.end();
+       ++i) {
+    answers.ref().push_back(*i);
+  }
+}
+
+template<class T, typename Iterator, typename Compare>
+inline void pareto_eps(
+  List_Ref<T> &answers, Iterator begin, Iterator end, Compare &c) {
+  pareto_eps(answers, begin, end, c,
+             typename Pareto_Has_Keys<Compare>::type());
+}
+
+#endif  // RTLIB_PARETO_EPS_HH_
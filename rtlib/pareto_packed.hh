@@ -0,0 +1,129 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_PARETO_PACKED_HH_
+#define RTLIB_PARETO_PACKED_HH_
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Packed dominance checks for multi-dimensional Pareto products.
+//
+// If every dimension is a numeric minimum or maximum, gapc generates a
+// member keys(e, e, k) in the comparator, which stores one key per
+// dimension in k (smaller is better). The keys of a Pareto front are
+// kept in one contiguous array per dimension. Thus, a candidate is
+// tested against a whole block of front members with branch-free
+// compares, which the compiler turns into SIMD instructions.
+
+template<typename Compare>
+struct Pareto_Has_Keys {
+  template<typename C> static char test(decltype(&C::keys));
+  template<typename C> static long test(...);
+  typedef std::integral_constant<bool, sizeof(test<Compare>(0)) == 1> type;
+};
+
+template<typename I, int D>
+class Pareto_Front {
+ private:
+    enum { BLOCK = 64 };
+
+    std::vector<double> keys[D];
+    std::vector<I> items_;
+
+ public:
+    size_t size() const { return items_.size(); }
+    const std::vector<I> &items() const { return items_; }
+
+    void push_back(const I &x, const double *k) {
+      items_.push_back(x);
+      for (int d = 0; d < D; ++d)
+        keys[d].push_back(k[d]);
+    }
+
+    // true, if a member is not worse than k in the dimensions [s, D)
+    bool covers(const double *k, int s = 0) const {
+      const size_t n = size();
+      for (size_t b = 0; b < n; b += BLOCK) {
+        const size_t e = b + BLOCK < n ? b + BLOCK : n;
+        unsigned char r = 0;
+        for (size_t j = b; j < e; ++j) {
+          unsigned char le = 1;
+          for (int d = s; d < D; ++d)
+            le &= keys[d][j] <= k[d];
+          r |= le;
+        }
+        if (r)
+          return true;
+      }
+      return false;
+    }
+
+    // true, if a member dominates k, i.e. is not worse in any and better
+    // in at least one dimension
+    bool dominates(const double *k) const {
+      const size_t n = size();
+      for (size_t b = 0; b < n; b += BLOCK) {
+        const size_t e = b + BLOCK < n ? b + BLOCK : n;
+        unsigned char r = 0;
+        for (size_t j = b; j < e; ++j) {
+          unsigned char le = 1;
+          unsigned char lt = 0;
+          for (int d = 0; d < D; ++d) {
+            le &= keys[d][j] <= k[d];
+            lt |= keys[d][j] < k[d];
+          }
+          r |= le & lt;
+        }
+        if (r)
+          return true;
+      }
+      return false;
+    }
+
+    // removes all members which are not better than k in any dimension,
+    // keeps the order of the others
+    void erase_covered(const double *k) {
+      const size_t n = size();
+      size_t o = 0;
+      for (size_t j = 0; j < n; ++j) {
+        unsigned char ge = 1;
+        for (int d = 0; d < D; ++d)
+          ge &= keys[d][j] >= k[d];
+        if (ge)
+          continue;
+        if (o != j) {
+          items_[o] = items_[j];
+          for (int d = 0; d < D; ++d)
+            keys[d][o] = keys[d][j];
+        }
+        ++o;
+      }
+      items_.resize(o);
+      for (int d = 0; d < D; ++d)
+        keys[d].resize(o);
+    }
+};
+
+#endif  // RTLIB_PARETO_PACKED_HH_
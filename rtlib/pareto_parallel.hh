@@ -0,0 +1,245 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_PARETO_PARALLEL_HH_
+#define RTLIB_PARETO_PARALLEL_HH_
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "list.hh"
+#include "pareto_dom_sort.hh"
+
+// Divide and conquer Pareto front (-P 5): a candidate list of at least
+// PARETO_PARALLEL_THRESHOLD elements is split into blocks, the partial
+// fronts of the blocks are computed in parallel and then merged pairwise
+// in a parallel reduction tree. Smaller lists - and builds without
+// OpenMP - use the sequential domination sort of -P 4.
+//
+// Inside the parallel CYK loops the work is spawned as OpenMP tasks,
+// i.e. threads waiting at the end of a diagonal pick it up, instead of
+// idling while one thread computes the front of a big apex cell.
+//
+// The blocks copy candidates between threads. Answer types with
+// reference counted members (String, Rope, lists, ...) are not safe to
+// copy concurrently, hence only trivially copyable types take the
+// parallel path, all others stay in the calling thread.
+
+template<class T>
+struct pareto_parallel_safe : std::is_trivially_copyable<T> {};
+
+#ifndef PARETO_PARALLEL_THRESHOLD
+#define PARETO_PARALLEL_THRESHOLD 2048
+#endif
+
+inline int pareto_parallel_threads() {
+#ifdef _OPENMP
+  if (omp_in_parallel()) {
+    return omp_get_num_threads();
+  }
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+template<typename F>
+inline void pareto_parallel_for(size_t n, F f, bool parallel = true) {
+#ifdef _OPENMP
+  if (!parallel) {
+    for (size_t i = 0; i < n; ++i) {
+      f(i);
+    }
+  } else if (omp_in_parallel()) {
+    #pragma omp taskloop
+    for (size_t i = 0; i < n; ++i) {
+      f(i);
+    }
+  } else {
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < n; ++i) {
+      f(i);
+    }
+  }
+#else
+  for (size_t i = 0; i < n; ++i) {
+    f(i);
+  }
+#endif
+}
+
+// true, if a is not worse than b in any dimension
+template<class T, typename Compare>
+inline bool pareto_covers(const T &a, const T &b, Compare &c) {
+  for (int i = 1; i <= c.dim; ++i) {
+    if (c(a, b, i) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// true, if a is not worse than b in any and better in one dimension
+template<class T, typename Compare>
+inline bool pareto_dominates(const T &a, const T &b, Compare &c) {
+  bool better = false;
+  for (int i = 1; i <= c.dim; ++i) {
+    int res = c(a, b, i);
+    if (res < 0) {
+      return false;
+    }
+    if (res > 0) {
+      better = true;
+    }
+  }
+  return better;
+}
+
+// sequential front of one block; like the domination sort, a later
+// candidate replaces an equal earlier one
+template<class T, typename Iterator, typename Compare>
+void pareto_front(
+  std::vector<T> &front, Iterator begin, Iterator end, Compare &c) {
+  for (; begin != end; ++begin) {
+    bool add = true;
+    for (size_t j = 0; j < front.size(); ++j) {
+      if (pareto_dominates(front[j], *begin, c)) {
+        add = false;
+        break;
+      }
+    }
+    if (!add) {
+      continue;
+    }
+    size_t o = 0;
+    for (size_t j = 0; j < front.size(); ++j) {
+      if (!pareto_covers(*begin, front[j], c)) {
+        front[o++] = front[j];
+      }
+    }
+    front.resize(o);
+    front.push_back(*begin);
+  }
+}
+
+// r = front of the union of the fronts a and b, b is the later block
+template<class T, typename Compare>
+void pareto_merge(std::vector<T> &r, const std::vector<T> &a,
+                  const std::vector<T> &b, Compare &c, bool parallel) {
+  const size_t n = a.size();
+  std::vector<char> keep(n + b.size());
+  pareto_parallel_for(keep.size(), [&](size_t i) {
+    bool k = true;
+    if (i < n) {
+      for (size_t j = 0; k && j < b.size(); ++j) {
+        k = !pareto_covers(b[j], a[i], c);
+      }
+    } else {
+      for (size_t j = 0; k && j < n; ++j) {
+        k = !pareto_dominates(a[j], b[i - n], c);
+      }
+    }
+    keep[i] = k;
+  }, parallel);
+  for (size_t i = 0; i < keep.size(); ++i) {
+    if (keep[i]) {
+      r.push_back(i < n ? a[i] : b[i - n]);
+    }
+  }
+}
+
+// parallel == false: the same divide and conquer in the calling thread
+template<class T, typename Iterator, typename Compare>
+void pareto_split_merge(std::vector<T> &r, Iterator begin, Iterator end,
+                        Compare &c, size_t parts, bool parallel = true) {
+  parallel = parallel && pareto_parallel_safe<T>::value;
+  const size_t n = std::distance(begin, end);
+  std::vector<Iterator> bounds;
+  bounds.push_back(begin);
+  for (size_t i = 1; i < parts; ++i) {
+    Iterator x = bounds.back();
+    std::advance(x, n / parts + (i <= n % parts ? 1 : 0));
+    bounds.push_back(x);
+  }
+  bounds.push_back(end);
+
+  std::vector<std::vector<T> > fronts(parts);
+  pareto_parallel_for(parts, [&](size_t i) {
+    pareto_front(fronts[i], bounds[i], bounds[i + 1], c);
+  }, parallel);
+
+  while (fronts.size() > 1) {
+    std::vector<std::vector<T> > next((fronts.size() + 1) / 2);
+    pareto_parallel_for(next.size(), [&](size_t i) {
+      if (2 * i + 1 < fronts.size()) {
+        pareto_merge(next[i], fronts[2 * i], fronts[2 * i + 1], c, parallel);
+      } else {
+        next[i].swap(fronts[2 * i]);
+      }
+    }, parallel);
+    fronts.swap(next);
+  }
+  r.swap(fronts.front());
+}
+
+template<class T, typename Iterator, typename Compare>
+void pareto_parallel(List_Ref<T> &answers, Iterator begin, Iterator end,
+                     Compare &c, std::false_type) {
+  pareto_domination_sort(answers, begin, end, c);
+}
+
+template<class T, typename Iterator, typename Compare>
+void pareto_parallel(List_Ref<T> &answers, Iterator begin, Iterator end,
+                     Compare &c, std::true_type) {
+  const size_t n = std::distance(begin, end);
+  const size_t threads = pareto_parallel_threads();
+  if (n < PARETO_PARALLEL_THRESHOLD || threads < 2) {
+    pareto_domination_sort(answers, begin, end, c);
+    return;
+  }
+
+  size_t parts = n / (PARETO_PARALLEL_THRESHOLD / 4);
+  if (parts > 2 * threads) {
+    parts = 2 * threads;
+  }
+  std::vector<T> r;
+  pareto_split_merge(r, begin, end, c, parts);
+  for (typename std::vector<T>::iterator i = r.begin(); i != r.end(); ++i) {
+    answers.ref().push_back(*i);
+  }
+}
+
+template<class T, typename Iterator, typename Compare>
+void pareto_parallel(
+  List_Ref<T> &answers, Iterator begin, Iterator end, Compare &c) {
+  pareto_parallel(answers, begin, end, c,
+                  typename pareto_parallel_safe<T>::type());
+}
+
+#endif  // RTLIB_PARETO_PARALLEL_HH_
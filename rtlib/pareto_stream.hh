@@ -0,0 +1,242 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_PARETO_STREAM_HH_
+#define RTLIB_PARETO_STREAM_HH_
+
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "empty.hh"
+#include "erase.hh"
+#include "list.hh"
+
+// Streaming 2D Pareto front behind gapc --pareto-stream.
+//
+// For A ^ B of two numeric minimum/maximum algebras, candidates are pushed
+// via push_back_pareto_<first>_<second>: while a cell is filled, its front
+// lives in a balanced tree (Pareto_List::front), ordered from the best to
+// the worst first component. Thus, the second component improves strictly
+// along the front, a dominated candidate is rejected in O(log n) by a
+// lookup of its neighbour and a new member is inserted in O(log n) plus
+// the members it dominates. Co-optimal duplicates are kept, such that the
+// Pareto choice fn returns the same set as for the unfiltered list.
+//
+// The generated code calls finalize_pareto_<first>_<second> before the
+// choice fn, which moves the front into the plain list. Until then, the
+// list itself stays empty.
+
+template<bool MAX>
+struct Pareto_Better {
+  template<typename T>
+  bool operator()(const T &a, const T &b) const {
+    return MAX ? b < a : a < b;
+  }
+};
+
+template<bool MAX>
+struct Pareto_First {
+  template<typename T>
+  bool operator()(const T &a, const T &b) const {
+    return Pareto_Better<MAX>()(a.first, b.first);
+  }
+};
+
+// allocated by the first push into a List_Ref, recognized by its deleter
+template<bool MAX1, class T, typename pos_int>
+class Pareto_List : public List<T, pos_int> {
+ public:
+    typedef std::multiset<T, Pareto_First<MAX1> > Front;
+    Front front;
+
+    struct Delete {
+      void operator()(List<T, pos_int> *l) const {
+        delete static_cast<Pareto_List*>(l);
+      }
+    };
+
+    static Pareto_List *get(List_Ref<T, pos_int> &x) {
+      if (!x.l || !boost::get_deleter<Delete>(x.l))
+        return 0;
+      return static_cast<Pareto_List*>(x.l.get());
+    }
+};
+
+template<bool MAX1, bool MAX2, class T, typename pos_int>
+inline void push_back_pareto(List_Ref<T, pos_int> &x, T &e);
+
+template<bool MAX1, bool MAX2, class T, typename pos_int>
+inline typename Pareto_List<MAX1, T, pos_int>::Front &pareto_front(
+  List_Ref<T, pos_int> &x) {
+  typedef Pareto_List<MAX1, T, pos_int> P;
+  P *p = P::get(x);
+  if (!p) {
+    p = new P();
+    if (x.l)
+      p->swap(*x.l);
+    x.l.reset(p, typename P::Delete());
+  }
+  if (!p->empty()) {
+    // pushed into again after finalize_pareto or filled elsewhere
+    List<T, pos_int> l;
+    l.swap(*p);
+    for (typename List<T, pos_int>::iterator i = l.begin(); i != l.end(); ++i)
+      push_back_pareto<MAX1, MAX2>(x, *i);
+  }
+  return p->front;
+}
+
+template<bool MAX1, bool MAX2, class T, typename pos_int>
+inline void push_back_pareto(List_Ref<T, pos_int> &x, T &e) {
+  assert(!isEmpty(e));
+  typedef typename Pareto_List<MAX1, T, pos_int>::Front Front;
+  typedef typename Front::iterator itr;
+  Pareto_Better<MAX1> b1;
+  Pareto_Better<MAX2> b2;
+  Front &l = pareto_front<MAX1, MAX2>(x);
+
+  // first member whose first component is not better than the one of e
+  itr lo = l.lower_bound(e);
+
+  // the predecessor has the best second component of all members with a
+  // better first component
+  if (lo != l.begin()) {
+    itr p = lo;
+    --p;
+    if (!b2(e.second, p->second)) {
+      erase(e);
+      return;
+    }
+  }
+  if (lo != l.end() && !b1(e.first, lo->first)) {
+    // equal first component
+    if (b2(lo->second, e.second)) {
+      erase(e);
+      return;
+    }
+    if (!b2(e.second, lo->second)) {
+      // co-optimal, appended behind its equals
+      l.insert(e);
+      return;
+    }
+  }
+
+  // e dominates the following members up to the first one with a better
+  // second component
+  itr j = lo;
+  for (; j != l.end() && !b2(j->second, e.second); ++j) {
+    erase(const_cast<T&>(*j));
+  }
+  l.erase(lo, j);
+  l.insert(j, e);
+}
+
+template<bool MAX1, class T, typename pos_int>
+inline void finalize_pareto(List_Ref<T, pos_int> &x) {
+  Pareto_List<MAX1, T, pos_int> *p = Pareto_List<MAX1, T, pos_int>::get(x);
+  if (!p || p->front.empty())
+    return;
+  p->insert(p->end(), p->front.begin(), p->front.end());
+  p->front.clear();
+}
+
+template<bool MAX1, bool MAX2, class T, typename pos_int>
+inline void append_pareto(List_Ref<T, pos_int> &x, List_Ref<T, pos_int> &e) {
+  finalize_pareto<MAX1>(e);
+  if (isEmpty(e))
+    return;
+  assert(&x.ref() != &e.ref());
+  List<T, pos_int> &l = e.ref();
+  for (typename List<T, pos_int>::iterator i = l.begin(); i != l.end(); ++i)
+    push_back_pareto<MAX1, MAX2>(x, *i);
+}
+
+template<class T, typename pos_int>
+inline void push_back_pareto_min_min(List_Ref<T, pos_int> &x, T &e) {
+  push_back_pareto<false, false>(x, e);
+}
+
+template<class T, typename pos_int>
+inline void push_back_pareto_min_max(List_Ref<T, pos_int> &x, T &e) {
+  push_back_pareto<false, true>(x, e);
+}
+
+template<class T, typename pos_int>
+inline void push_back_pareto_max_min(List_Ref<T, pos_int> &x, T &e) {
+  push_back_pareto<true, false>(x, e);
+}
+
+template<class T, typename pos_int>
+inline void push_back_pareto_max_max(List_Ref<T, pos_int> &x, T &e) {
+  push_back_pareto<true, true>(x, e);
+}
+
+template<class T, typename pos_int>
+inline void append_pareto_min_min(
+  List_Ref<T, pos_int> &x, List_Ref<T, pos_int> &e) {
+  append_pareto<false, false>(x, e);
+}
+
+template<class T, typename pos_int>
+inline void append_pareto_min_max(
+  List_Ref<T, pos_int> &x, List_Ref<T, pos_int> &e) {
+  append_pareto<false, true>(x, e);
+}
+
+template<class T, typename pos_int>
+inline void append_pareto_max_min(
+  List_Ref<T, pos_int> &x, List_Ref<T, pos_int> &e) {
+  append_pareto<true, false>(x, e);
+}
+
+template<class T, typename pos_int>
+inline void append_pareto_max_max(
+  List_Ref<T, pos_int> &x, List_Ref<T, pos_int> &e) {
+  append_pareto<true, true>(x, e);
+}
+
+template<class T, typename pos_int>
+inline void finalize_pareto_min_min(List_Ref<T, pos_int> &x) {
+  finalize_pareto<false>(x);
+}
+
+template<class T, typename pos_int>
+inline void finalize_pareto_min_max(List_Ref<T, pos_int> &x) {
+  finalize_pareto<false>(x);
+}
+
+template<class T, typename pos_int>
+inline void finalize_pareto_max_min(List_Ref<T, pos_int> &x) {
+  finalize_pareto<true>(x);
+}
+
+template<class T, typename pos_int>
+inline void finalize_pareto_max_max(List_Ref<T, pos_int> &x) {
+  finalize_pareto<true>(x);
+}
+
+#endif  // RTLIB_PARETO_STREAM_HH_
@@ -34,6 +34,7 @@
 #define _MOVE_RANGE(__it1, __it2, __in) std::copy(__it1, __it2, __in)
 #endif
 
+#include <cassert>
 #include <iostream>
 #include <deque>
 #include <iterator>
@@ -42,6 +43,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include "list.hh"
+#include "pareto_packed.hh"
 
 template <class T>
 class y_list : public std::deque<T*> {};
@@ -511,7 +513,8 @@ void y_sortedSplit(
 
 template<class T, typename Iterator, typename Compare>
 void y_bruteSolveSC(
-  y_list<T> &answers, Iterator begin, Iterator end, Compare &c, int dim) {
+  y_list<T> &answers, Iterator begin, Iterator end, Compare &c, int dim,
+  std::false_type) {
     // n^2 adding
     Iterator ref = begin;
     if (ref != end) {
@@ -535,6 +538,30 @@ void y_bruteSolveSC(
     }
 }
 
+template<class T, typename Iterator, typename Compare>
+void y_bruteSolveSC(
+  y_list<T> &answers, Iterator begin, Iterator end, Compare &c, int dim,
+  std::true_type) {
+    assert(dim == Compare::dim);
+    // dimension 1 is presorted, thus only the keys of [2, dim] matter
+    Pareto_Front<T*, Compare::dim> front;
+    double k[Compare::dim];
+    for (Iterator ref = begin; ref != end; ++ref) {
+       c.keys(*ref, *ref, k);
+       if (!front.covers(k, 1)) {
+            front.push_back(&(*ref), k);
+            answers.push_back(&(*ref));
+       }
+    }
+}
+
+template<class T, typename Iterator, typename Compare>
+inline void y_bruteSolveSC(
+  y_list<T> &answers, Iterator begin, Iterator end, Compare &c, int dim) {
+    y_bruteSolveSC(answers, begin, end, c, dim,
+                   typename Pareto_Has_Keys<Compare>::type());
+}
+
 // ///--------------------------  Solve DC -------------------------------
 
 
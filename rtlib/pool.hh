@@ -31,13 +31,16 @@
 // tr1 has it
 #include <boost/cstdint.hpp>
 
+#include "arena.hh"
 #include "map_pool.hh"
 
 // no element destructors are called from the pool destructor
 template <class K>
 class Pool {
  private:
+#if !defined(USE_ARENA) && !defined(USE_SYSTEM_MALLOC)
     Map::Pool<K> pool;
+#endif
 
     Pool(const Pool &);
     Pool &operator=(const Pool&);
@@ -57,12 +60,26 @@ class Pool {
     }
 
     K * malloc() {
+#if defined(USE_ARENA)
+      return static_cast<K*>(Arena::local().malloc(sizeof(K)));
+#elif defined(USE_SYSTEM_MALLOC)
+      K *r = static_cast<K*>(std::malloc(sizeof(K)));
+      assert(r);
+      return r;
+#else
       return pool.malloc();
+#endif
     }
 
     void free(K *x) {
       assert(x);
+#if defined(USE_ARENA)
+      Arena::local().free(x, sizeof(K));
+#elif defined(USE_SYSTEM_MALLOC)
+      std::free(x);
+#else
       pool.free(x);
+#endif
     }
 };
 
@@ -112,6 +112,28 @@ inline void push_back_min_other(List_Ref<T, pos_int> &x, T &e) {
   erase(e);
 }
 
+// lazy product evaluation, see Product::Base::set_lazy():
+// can a candidate with the left component e still enter x?
+
+template<class T, typename L>
+inline bool survives(T &x, const L &e) {
+  return true;
+}
+
+template<class T, typename pos_int, typename L>
+inline bool survives_max_other(List_Ref<T, pos_int> &x, const L &e) {
+  if (isEmpty(x) || isEmpty(e))
+    return true;
+  return !(left_most(e) < left_most(x.ref().front()));
+}
+
+template<class T, typename pos_int, typename L>
+inline bool survives_min_other(List_Ref<T, pos_int> &x, const L &e) {
+  if (isEmpty(x) || isEmpty(e))
+    return true;
+  return !(left_most(x.ref().front()) < left_most(e));
+}
+
 // FIXME remove List_Ref versions of max/min/sum pushback/append
 
 template<class T, typename pos_int>
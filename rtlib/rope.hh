@@ -24,6 +24,7 @@
 #ifndef RTLIB_ROPE_HH_
 #define RTLIB_ROPE_HH_
 
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <algorithm>
@@ -44,7 +45,12 @@
 namespace rope {
 class Ref_Count {
  private:
+#ifdef _OPENMP
+  // copies of a rope in the table cells of other threads share its blocks
+  std::atomic<uint32_t> i;
+#else
   uint32_t i;
+#endif
 
  public:
   enum { ENABLED = 1, block_size = 60 };
@@ -59,6 +65,11 @@ class Ref_Count {
     assert(i > 0);
     --i;
   }
+  // true, if the last reference was dropped
+  bool release() {
+    assert(i > 0);
+    return !--i;
+  }
   bool operator==(uint32_t x) const { return i == x; }
 };
 
@@ -70,6 +81,7 @@ class No_Ref_Count {
   }
   void operator--() {
   }
+  bool release() { return true; }
   bool operator==(uint32_t x) const { assert(!x); return true; }
 };
 
@@ -241,6 +253,9 @@ class Ref {
     static Pool<Block<Refcount> > pool;
 
  private:
+    // the inline rope of rope_small.hh walks the blocks of its spill
+    template<typename> friend class Ref;
+
 #ifdef CHECKPOINTING_INTEGRATED
     friend class boost::serialization::access;
     template <class Archive>
@@ -258,8 +273,7 @@ class Ref {
 
     void del() {
       if (first) {
-        --first->refcount;
-        if (first->refcount == 0) {
+        if (first->refcount.release()) {
           Block<Refcount>* x = first->next;
           delete first;
           while (x) {
@@ -276,22 +290,25 @@ class Ref {
       empty_ = false;
     }
 
-    Block<Refcount> *copy_blocks(Block<Refcount>* dest, Block<Refcount>* src) {
+    // returns the last written block; src_last ends a read-only view
+    // of a shared chain, whose owner may have appended behind it
+    Block<Refcount> *copy_blocks(Block<Refcount>* dest, Block<Refcount>* src,
+        Block<Refcount>* src_last = 0, unsigned char last_pos = 0) {
       Block<Refcount>* x = dest;
       Block<Refcount>* y = src;
-      while (y) {
+      for (;;) {
         assert(x->refcount == 1);
-        x->pos = y->pos;
-        std::memcpy(x->array, y->array, y->pos);
+        x->pos = y == src_last ? last_pos : y->pos;
+        std::memcpy(x->array, y->array, x->pos);
+        if (y == src_last)
+          break;
         y = y->next;
-        if (y && !x->next)
+        if (!y)
+          break;
+        if (!x->next)
           x->next = new Block<Refcount>();
         x = x->next;
       }
-      if (!x) {
-        assert(dest);
-        x = dest;
-      }
       return x;
     }
 
@@ -325,11 +342,10 @@ class Ref {
       empty_ = false;
       if (readonly == true) {
         Block<Refcount> *tfirst = new Block<Refcount>();
-        Block<Refcount> *tlast = copy_blocks(tfirst, first);
+        Block<Refcount> *tlast = copy_blocks(tfirst, first, last, readonly());
         del();
         first = tfirst;
         last = tlast;
-        return;
       }
       if (!first) {
         first = last = new Block<Refcount>();
@@ -731,7 +747,13 @@ inline std::ostream &operator<<(std::ostream &o,
 
 }  // namespace rope
 
+#ifdef ROPE_SMALL
+#include "rope_small.hh"
+
+typedef rope::Ref<rope::Inline> Rope;
+#else
 typedef rope::Ref<rope::Ref_Count> Rope;
+#endif
 
 
 template<typename X>
@@ -0,0 +1,368 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_ROPE_SMALL_HH_
+#define RTLIB_ROPE_SMALL_HH_
+
+#ifdef CHECKPOINTING_INTEGRATED
+#error "small ropes (ROPE_SMALL) do not support checkpointing"
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+#include <ostream>
+
+// Inline representation of short ropes, selected by ROPE_SMALL
+// (gapc --small-ropes); part of rope.hh.
+//
+// Up to CAPACITY characters are stored inside the object itself, i.e.
+// neither creating nor copying such a rope allocates or touches a
+// reference count. A longer rope is spilled into an ordinary
+// rope::Ref<Ref_Count>, whose blocks come from the Pool - or from the
+// per thread arena under USE_ARENA, which releases them in bulk - and
+// are shared read-only between copies.
+
+namespace rope {
+
+struct Inline {
+};
+
+template<>
+class Ref<Inline> {
+ public:
+    enum { CAPACITY = 30 };
+
+ private:
+    typedef Ref<Ref_Count> Big;
+
+    enum { BIG = 0xff };
+
+    union {
+      unsigned char array[CAPACITY];
+      unsigned char big_[sizeof(Big)];
+      Block<Ref_Count> *align_;
+    };
+    // number of inline characters or BIG
+    unsigned char len;
+    bool empty_;
+
+    bool is_big() const { return len == BIG; }
+    Big &big() { return *reinterpret_cast<Big*>(big_); }
+    const Big &big() const { return *reinterpret_cast<const Big*>(big_); }
+
+    void del() {
+      if (is_big())
+        big().~Big();
+      len = 0;
+      empty_ = false;
+    }
+
+    void copy(const Ref<Inline> &r) {
+      if (r.empty_) {
+        empty_ = true;
+        return;
+      }
+      if (r.is_big()) {
+        new (big_) Big(r.big());
+      } else {
+        std::memcpy(array, r.array, r.len);
+      }
+      len = r.len;
+    }
+
+    // moves the inline characters into a block chain
+    void spill() {
+      assert(!is_big());
+      char t[CAPACITY + 1];
+      unsigned char l = len;
+      std::memcpy(t, array, l);
+      t[l] = 0;
+      new (big_) Big();
+      len = BIG;
+      if (l)
+        big().append(t, l);
+    }
+
+    bool fits(uint32_t l) const {
+      return !is_big() && len + l <= CAPACITY;
+    }
+
+ public:
+    Ref()
+      : len(0), empty_(false) {
+    }
+
+    Ref(const Ref<Inline> &r)
+      : len(0), empty_(false) {
+      copy(r);
+    }
+
+    explicit Ref(const char *s)
+      : len(0), empty_(false) {
+      assert(s);
+      if (s && *s)
+        append(s);
+    }
+
+    ~Ref() {
+      del();
+    }
+
+    Ref &operator=(const Ref<Inline> &r) {
+      if (this == &r)
+        return *this;
+      del();
+      copy(r);
+      return *this;
+    }
+
+    void move(Ref<Inline> &o) {
+      del();
+      if (o.is_big()) {
+        new (big_) Big();
+        big().move(o.big());
+      } else {
+        std::memcpy(array, o.array, o.len);
+      }
+      len = o.len;
+      empty_ = o.empty_;
+      o.del();
+    }
+
+    void swap(Ref<Inline> &o) {
+      Ref<Inline> t;
+      t.move(o);
+      o.move(*this);
+      move(t);
+    }
+
+    void append(char c) {
+      empty_ = false;
+      if (fits(1)) {
+        array[len++] = c;
+        return;
+      }
+      if (!is_big())
+        spill();
+      big().append(c);
+    }
+
+    void append(const Ref<Inline> &o) {
+      if (o.is_big()) {
+        empty_ = false;
+        if (!len) {
+          // share the blocks instead of copying them
+          new (big_) Big(o.big());
+          len = BIG;
+          return;
+        }
+        if (!is_big())
+          spill();
+        big().append(o.big());
+        return;
+      }
+      if (!o.len)
+        return;
+      char t[CAPACITY + 1];
+      std::memcpy(t, o.array, o.len);
+      t[o.len] = 0;
+      append(t, o.len);
+    }
+
+    void append(const char *s, uint32_t l) {
+      if (!l)
+        return;
+      empty_ = false;
+      if (fits(l)) {
+        std::memcpy(array + len, s, l);
+        len += l;
+        return;
+      }
+      if (!is_big())
+        spill();
+      big().append(s, l);
+    }
+
+    void append(int j) {
+      char s[12];
+      unsigned char l;
+      char *x = int_to_str(s, &l, j);
+      assert(l);
+      append(x, l);
+    }
+
+    void append(char c, uint32_t l) {
+      if (!l)
+        return;
+      empty_ = false;
+      if (fits(l)) {
+        std::memset(array + len, c, l);
+        len += l;
+        return;
+      }
+      if (!is_big())
+        spill();
+      big().append(c, l);
+    }
+
+    void append(const char *s) {
+      append(s, std::strlen(s));
+    }
+
+    void put(std::ostream &o) const {
+      if (is_big())
+        big().put(o);
+      else
+        o.write(reinterpret_cast<const char*>(array), len);
+    }
+
+    // walks the inline array or the blocks of the chain; the last block
+    // of a shared chain may hold more characters than this rope
+    class Iterator {
+     private:
+        friend class Ref<Inline>;
+        const Block<Ref_Count> *b;
+        const unsigned char *p;
+        unsigned char j, z;
+        size_t rest;
+
+        void load() {
+          if (!rest) {
+            j = z = 0;
+            return;
+          }
+          p = b->array;
+          j = 0;
+          z = std::min(size_t(b->pos), rest);
+        }
+
+        explicit Iterator(const Ref<Inline> &r)
+          : b(0), p(0), j(0), z(0), rest(r.size()) {
+          if (r.is_big()) {
+            b = r.big().first;
+            load();
+          } else {
+            p = r.array;
+            z = r.len;
+          }
+        }
+
+        Iterator() : b(0), p(0), j(0), z(0), rest(0) {}
+
+     public:
+        unsigned char operator*() const { assert(rest); return p[j]; }
+
+        Iterator &operator++() {
+          assert(rest);
+          --rest;
+          if (++j == z && b) {
+            b = b->next;
+            load();
+          }
+          return *this;
+        }
+
+        bool operator==(const Iterator &o) const { return rest == o.rest; }
+        bool operator!=(const Iterator &o) const { return rest != o.rest; }
+    };
+
+    typedef Iterator iterator;
+    typedef Iterator const_iterator;
+    iterator begin() const { return Iterator(*this); }
+    iterator end() const { return Iterator(); }
+
+    size_t size() const {
+      return is_big() ? big().size() : len;
+    }
+
+    void empty() {
+      empty_ = true;
+    }
+
+    bool isEmpty() const { return empty_; }
+
+    bool operator==(const Ref<Inline> &o) const {
+      if (!is_big() && !o.is_big())
+        return len == o.len && !std::memcmp(array, o.array, len);
+      if (size() != o.size())
+        return false;
+      for (iterator i = begin(), j = o.begin(); i != end(); ++i, ++j)
+        if (*i != *j)
+          return false;
+      return true;
+    }
+
+    bool operator!=(const Ref<Inline> &o) const {
+      return !(*this == o);
+    }
+
+    // Same order as rope::Ref<Ref_Count>, which compares chunks of
+    // block_size characters by their length first, e.g. such that
+    // std::map<Rope, ...> iterates in the same order in both modes.
+    bool operator<(const Ref<Inline> &o) const {
+      const size_t n = Block<Ref_Count>::block_size;
+      size_t a = size(), b = o.size();
+      iterator i = begin(), j = o.begin();
+      for (size_t pos = 0; pos < a || pos < b; ) {
+        size_t x = std::min(a - std::min(a, pos), n);
+        size_t y = std::min(b - std::min(b, pos), n);
+        if (x != y)
+          return x < y;
+        for (size_t k = 0; k < x; ++k, ++i, ++j)
+          if (*i != *j)
+            return *i < *j;
+        pos += x;
+      }
+      return false;
+    }
+
+    uint32_t hashable_value() const {
+      hash_to_uint32::djb hash_fn;
+      uint32_t hash = hash_fn.initial();
+      for (iterator i = begin(); i != end(); ++i)
+        hash_fn.next(hash, static_cast<char>(*i));
+      return hash;
+    }
+
+    char front() const {
+      assert(!isEmpty());
+      return *begin();
+    }
+};
+
+}  // namespace rope
+
+namespace std {
+
+template <>
+inline
+void swap<rope::Ref<rope::Inline> >(
+  rope::Ref<rope::Inline> &a, rope::Ref<rope::Inline> &b) {
+  a.swap(b);
+}
+
+}  // namespace std
+
+#endif  // RTLIB_ROPE_SMALL_HH_
@@ -38,17 +38,114 @@
 #error "e.g. under Debian/Ubuntu: apt-get install libgsl0-dev libatlas-base-dev"
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
-#include "singleton.hh"
+#include <boost/cstdint.hpp>
 
 
 namespace scil {
+
+// Counter based Philox4x32-10 generator (Salmon et al., SC'11) as a GSL
+// rng type: sample i of a run draws from its own stream (seed, i), thus
+// the samples do not depend on each other - nor on the number of threads
+// which draw them.
+struct philox {
+  enum { ROUNDS = 10 };
+
+  struct state {
+    uint32_t key[2];
+    uint32_t ctr[4];
+    uint32_t out[4];
+    unsigned used;
+  };
+
+  static void round(uint32_t *c, const uint32_t *k) {
+    uint64_t p0 = uint64_t(0xD2511F53) * c[0];
+    uint64_t p1 = uint64_t(0xCD9E8D57) * c[2];
+    uint32_t r[4] = {
+      uint32_t(p1 >> 32) ^ c[1] ^ k[0], uint32_t(p1),
+      uint32_t(p0 >> 32) ^ c[3] ^ k[1], uint32_t(p0) };
+    c[0] = r[0];
+    c[1] = r[1];
+    c[2] = r[2];
+    c[3] = r[3];
+  }
+
+  static void block(state *s) {
+    uint32_t k[2] = { s->key[0], s->key[1] };
+    for (unsigned i = 0; i < 4; ++i)
+      s->out[i] = s->ctr[i];
+    for (unsigned i = 0; i < ROUNDS; ++i) {
+      round(s->out, k);
+      k[0] += 0x9E3779B9;
+      k[1] += 0xBB67AE85;
+    }
+    if (!++s->ctr[0])
+      ++s->ctr[1];
+    s->used = 0;
+  }
+
+  // seed and stream select the key and the upper half of the counter
+  static void select(state *s, uint64_t seed, uint64_t stream) {
+    s->key[0] = uint32_t(seed);
+    s->key[1] = uint32_t(seed >> 32);
+    s->ctr[0] = s->ctr[1] = 0;
+    s->ctr[2] = uint32_t(stream);
+    s->ctr[3] = uint32_t(stream >> 32);
+    s->used = 4;
+  }
+
+  static void set(void *v, unsigned long seed) {
+    select(static_cast<state*>(v), seed, 0);
+  }
+
+  static unsigned long get(void *v) {
+    state *s = static_cast<state*>(v);
+    if (s->used == 4)
+      block(s);
+    return s->out[s->used++];
+  }
+
+  static double get_double(void *v) {
+    return get(v) / 4294967296.0;
+  }
+
+  static const gsl_rng_type *type() {
+    static const gsl_rng_type t = { "gapc_philox4x32", 0xffffffffUL, 0,
+      sizeof(state), &set, &get, &get_double };
+    return &t;
+  }
+};
+
+// without --seed, GSL_RNG_SEED from the environment is used
+inline uint64_t default_seed() {
+  gsl_rng_env_setup();
+  return gsl_rng_default_seed;
+}
+
+// With --seed, sample i draws from the Philox stream (seed, i). Otherwise
+// all samples draw one after the other from one gsl_rng_default
+// generator, i.e. GSL_RNG_TYPE and GSL_RNG_SEED select the output as
+// before.
+inline bool &streams() {
+  static bool b = false;
+  return b;
+}
+
 class rng {
  private:
     gsl_rng *t;
 
+    rng(const rng &);
+    rng &operator=(const rng &);
+
  public:
     rng()
       : t(0) {
@@ -57,6 +154,14 @@ class rng {
       t = gsl_rng_alloc(rng_type);
     }
 
+    // 0 selects gsl_rng_default
+    explicit rng(const gsl_rng_type *rng_type)
+      : t(0) {
+      uint64_t seed = default_seed();
+      t = gsl_rng_alloc(rng_type ? rng_type : gsl_rng_default);
+      gsl_rng_set(t, seed);
+    }
+
     ~rng() {
       assert(t);
       gsl_rng_free(t);
@@ -65,8 +170,122 @@ class rng {
     const gsl_rng *operator*() const {
       return t;
     }
+
+    philox::state &philox_state() {
+      assert(t->type == philox::type());
+      return *static_cast<philox::state*>(t->state);
+    }
+
+    void stream(uint64_t seed, uint64_t id) {
+      philox::select(&philox_state(), seed, id);
+    }
+};
+
+// each thread draws from its own generator
+inline rng &local_rng() {
+  static thread_local rng r(streams() ? philox::type() : 0);
+  return r;
+}
+
+#ifndef SAMPLE_CACHE_BYTES
+#define SAMPLE_CACHE_BYTES (size_t(256) << 20)
+#endif
+
+// The sub-problem of the next draw with --sample-cache: the generated
+// backtrace code of a nonterminal names it right before its choice fn,
+// i.e. before sample_filter sees the candidates of the cell. Together
+// with the number of candidates it identifies the alternative set of
+// the draw - the candidates and weights of a cell are the same in every
+// sample.
+struct cell_key {
+  enum { MAX_INDICES = 4 };
+  // 0: no cell, e.g. for parameterized nonterminals
+  unsigned nt;
+  unsigned n;
+  unsigned idx[MAX_INDICES];
+  size_t m;
+
+  bool operator==(const cell_key &o) const {
+    return nt == o.nt && n == o.n && m == o.m &&
+      std::equal(idx, idx + n, o.idx);
+  }
 };
 
+struct cell_key_hash {
+  size_t operator()(const cell_key &k) const {
+    uint64_t h = k.nt;
+    for (unsigned i = 0; i < k.n; ++i)
+      h = h * 0x9e3779b97f4a7c15ULL + k.idx[i];
+    h = h * 0x9e3779b97f4a7c15ULL + k.m;
+    return h ^ (h >> 29);
+  }
+};
+
+inline cell_key &current_cell() {
+  static thread_local cell_key k;
+  return k;
+}
+
+template<typename... I>
+inline void sample_cell(unsigned nt, I... idx) {
+  static_assert(sizeof...(I) <= cell_key::MAX_INDICES, "too many tracks");
+  cell_key &k = current_cell();
+  unsigned v[] = { 0u, static_cast<unsigned>(idx)... };
+  k.nt = nt;
+  k.n = sizeof...(I);
+  std::copy(v + 1, v + 1 + k.n, k.idx);
+}
+
+// Alias tables of the cells sampled so far (--sample-cache). Each sample
+// visits mostly the same cells - thus the O(m) preprocessing is done once
+// per cell, and a hit costs one lookup of the cell key. Once the memory
+// cap is reached, new tables are built on the fly again. One cache per
+// thread, i.e. no locking.
+class discrete_cache {
+ private:
+    typedef std::unordered_map<cell_key, gsl_ran_discrete_t*, cell_key_hash>
+      map_t;
+    map_t map;
+    size_t bytes;
+
+    discrete_cache(const discrete_cache &);
+    discrete_cache &operator=(const discrete_cache &);
+
+ public:
+    discrete_cache()
+      : bytes(0) {
+    }
+
+    ~discrete_cache() {
+      for (map_t::iterator i = map.begin(); i != map.end(); ++i)
+        gsl_ran_discrete_free(i->second);
+    }
+
+    gsl_ran_discrete_t *find(const cell_key &k) const {
+      map_t::const_iterator i = map.find(k);
+      return i == map.end() ? 0 : i->second;
+    }
+
+    // returns 0 if the cache is full
+    gsl_ran_discrete_t *insert(const cell_key &k,
+                               const std::vector<double> &w) {
+      assert(k.nt && k.m == w.size());
+      // alias and probability arrays
+      size_t b = w.size() * (sizeof(double) + sizeof(size_t));
+      if (bytes + b > SAMPLE_CACHE_BYTES)
+        return 0;
+      bytes += b;
+      gsl_ran_discrete_t *t = gsl_ran_discrete_preproc(w.size(), &w[0]);
+      map[k] = t;
+      return t;
+    }
+};
+
+inline discrete_cache &local_discrete_cache() {
+  static thread_local discrete_cache c;
+  return c;
+}
+
 class ran_discrete {
  private:
     gsl_ran_discrete_t *x;
@@ -74,23 +293,46 @@ class ran_discrete {
     std::vector<double> array;
     enum State { CLEAR, PUSH, SAMPLE };
     State state;
+    // x is owned by the discrete_cache
+    bool cached;
+    // number of candidates of x
+    size_t m;
+#ifdef SAMPLE_CACHE
+    // the cell of a cache miss, x is stored for it by init()
+    cell_key key;
+#endif
+
+    void release() {
+      if (x && !cached)
+        gsl_ran_discrete_free(x);
+      x = 0;
+      cached = false;
+    }
 
  public:
     ran_discrete()
-      : x(0), r(Singleton<scil::rng>::ref()), state(CLEAR) {
+      : x(0), r(local_rng()), state(CLEAR), cached(false), m(0) {
       array.reserve(4096/sizeof(double));
+#ifdef SAMPLE_CACHE
+      key.nt = 0;
+#endif
     }
     explicit ran_discrete(rng &a)
-      : x(0), r(a), state(CLEAR) {
+      : x(0), r(a), state(CLEAR), cached(false), m(0) {
       array.reserve(4096/sizeof(double));
+#ifdef SAMPLE_CACHE
+      key.nt = 0;
+#endif
     }
     ran_discrete(rng &a, size_t b)
-      : x(0), r(a), state(CLEAR) {
+      : x(0), r(a), state(CLEAR), cached(false), m(0) {
       array.reserve(b);
+#ifdef SAMPLE_CACHE
+      key.nt = 0;
+#endif
     }
     ~ran_discrete() {
-      if (x)
-        gsl_ran_discrete_free(x);
+      release();
     }
     void clear() {
       state = CLEAR;
@@ -101,25 +343,156 @@ class ran_discrete {
       state = PUSH;
       array.push_back(d);
     }
+    // With --sample-cache: true, if the table of the current cell with n
+    // candidates is cached - then sample() draws without any weights. On
+    // false, the weights have to be pushed and init() stores the table.
+    bool init_cached(size_t n) {
+#ifdef SAMPLE_CACHE
+      cell_key &c = current_cell();
+      key = c;
+      key.m = n;
+      c.nt = 0;
+      if (!key.nt)
+        return false;
+      gsl_ran_discrete_t *t = local_discrete_cache().find(key);
+      if (!t)
+        return false;
+      release();
+      key.nt = 0;
+      x = t;
+      cached = true;
+      m = n;
+      state = SAMPLE;
+      return true;
+#else
+      return false;
+#endif
+    }
     void init() {
       assert(state == PUSH);
       state = SAMPLE;
-      if (x)
-        gsl_ran_discrete_free(x);
+      release();
+      m = array.size();
+#ifdef SAMPLE_CACHE
+      if (key.nt) {
+        x = local_discrete_cache().insert(key, array);
+        key.nt = 0;
+        cached = x != 0;
+        if (cached)
+          return;
+      }
+#endif
       x = gsl_ran_discrete_preproc(array.size(), &array[0]);
     }
     size_t sample() {
       assert(state == SAMPLE);
       size_t s = gsl_ran_discrete(*r, x);
-      assert(s < array.size());
+      assert(s < m);
       return s;
     }
     double sample_value() {
+      assert(array.size() == m);
       size_t k = sample();
       return array[k];
     }
 };
 
+inline ran_discrete &local_ran_discrete() {
+  static thread_local ran_discrete d;
+  return d;
+}
+
+// Draws the -r samples, with streams() sample i from stream (seed, i) of
+// its thread's generator. Under OpenMP these samples are spread across
+// the threads in blocks, whose output is buffered and printed in sample
+// order - i.e. the output for a given seed does not depend on the number
+// of threads.
+template<typename Draw>
+inline void draw_samples(std::ostream &out, unsigned n, uint64_t seed,
+                         Draw draw) {
+  if (!streams()) {
+    for (unsigned i = 0; i < n; ++i)
+      draw(out);
+    return;
+  }
+#ifdef _OPENMP
+  const unsigned block = 1024;
+  std::vector<std::string> buffer;
+  for (unsigned b = 0; b < n; b += block) {
+    unsigned m = std::min(block, n - b);
+    buffer.resize(m);
+    #pragma omp parallel for schedule(dynamic)
+    for (unsigned i = 0; i < m; ++i) {
+      local_rng().stream(seed, b + i);
+      std::ostringstream o;
+      draw(o);
+      buffer[i] = o.str();
+    }
+    for (unsigned i = 0; i < m; ++i)
+      out << buffer[i];
+  }
+#else
+  for (unsigned i = 0; i < n; ++i) {
+    local_rng().stream(seed, i);
+    draw(out);
+  }
+#endif
+}
+
+// --sample-batch: the (ascending) ids of the samples the current cell is
+// drawn for
+inline std::vector<unsigned> &batch() {
+  static thread_local std::vector<unsigned> v;
+  return v;
+}
+
+// the stream position of each sample of the batch
+inline std::vector<philox::state> &batch_states() {
+  static thread_local std::vector<philox::state> v;
+  return v;
+}
+
+// While in scope, the generator of the thread continues the stream of
+// sample id - thus, each sample of a batch draws the same numbers in the
+// same order as under draw_samples.
+class batch_sample {
+ private:
+    unsigned id;
+
+    batch_sample(const batch_sample &);
+    batch_sample &operator=(const batch_sample &);
+
+ public:
+    explicit batch_sample(unsigned i)
+      : id(i) {
+      local_rng().philox_state() = batch_states()[id];
+    }
+    ~batch_sample() {
+      batch_states()[id] = local_rng().philox_state();
+    }
+};
+
+// All -r samples in one backtrace: each cell partitions its samples among
+// its candidates, and each chosen candidate is descended once with its
+// part (see sample_filter and evaluate_batch). The output is the same as
+// the one of draw_samples for the same seed.
+template<typename Draw>
+inline void draw_batch(std::ostream &out, unsigned n, uint64_t seed,
+                       Draw draw) {
+  if (!n)
+    return;
+  std::vector<philox::state> &s = batch_states();
+  s.resize(n);
+  for (unsigned i = 0; i < n; ++i)
+    philox::select(&s[i], seed, i);
+  std::vector<unsigned> old;
+  old.swap(batch());
+  for (unsigned i = 0; i < n; ++i)
+    batch().push_back(i);
+  draw(out);
+  batch().swap(old);
+}
+
 }  // namespace scil
 
 #endif
@@ -572,12 +572,20 @@ T Fiber<T, Size, alphset>::null_elem(0);
   // when-using-size-t-on-mac-os
 
   #ifdef __x86_64__
-    typedef Fiber<uint64_t, unsigned char> Shape;
+    typedef Fiber<uint64_t, unsigned char> Shape_Fiber;
   #else
-    typedef Fiber<uint32_t, unsigned char> Shape;
+    typedef Fiber<uint32_t, unsigned char> Shape_Fiber;
   #endif
 #else
-  typedef Fiber<size_t, unsigned char> Shape;
+  typedef Fiber<size_t, unsigned char> Shape_Fiber;
+#endif
+
+#if defined(SHAPE_INTERN) && defined(SHAPE_SMALL)
+#error "SHAPE_INTERN and SHAPE_SMALL are mutually exclusive"
+#endif
+
+#if !defined(SHAPE_INTERN) && !defined(SHAPE_SMALL)
+typedef Shape_Fiber Shape;
 #endif
 
 
@@ -778,4 +786,16 @@ back(Fiber<T, Size, alphset> &a, char r = 0) {
   return *i;
 }
 
+#ifdef SHAPE_INTERN
+#include "shape_intern.hh"
+
+typedef Interned_Shape<Shape_Fiber> Shape;
+#endif
+
+#ifdef SHAPE_SMALL
+#include "shape_small.hh"
+
+typedef Small_Shape<Shape_Fiber> Shape;
+#endif
+
 #endif  // RTLIB_SHAPE_HH_
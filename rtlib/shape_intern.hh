@@ -0,0 +1,553 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_SHAPE_INTERN_HH_
+#define RTLIB_SHAPE_INTERN_HH_
+
+#ifdef CHECKPOINTING_INTEGRATED
+#error "interned shapes (SHAPE_INTERN) do not support checkpointing"
+#endif
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "arena.hh"
+#include "bitops.hh"
+
+// Global shape interning, selected by SHAPE_INTERN (gapc --intern-shapes).
+//
+// Every distinct shape is stored once in a Shape_Table and represented by
+// its 32 bit id, i.e. copying, hashing and comparing shapes for equality
+// are integer operations. Concatenations are memoised on (id, id) pairs,
+// such that a shape algebra builds each distinct shape only once per run.
+//
+// Lookups never lock: entries are never moved or removed, and both hash
+// indices are published with release stores. Only the insertion of a new
+// shape or pair takes the table mutex. Ids are dense, thus an id is also a
+// direct index into per class tables of size Shape_Table::size().
+
+template <typename F>
+class Shape_Table {
+ public:
+    enum { EMPTY = 0, NULL_ELEM = 1 };
+    static const uint32_t NONE = uint32_t(-1);
+
+ private:
+    struct Entry {
+      F shape;
+      uint64_t hash;
+      char front;
+      char back;
+      // memoised id of tail(shape)
+      std::atomic<uint32_t> tail;
+      Entry() : hash(0), front(0), back(0), tail(NONE) {}
+    };
+
+    // chunk c holds the ids [1024 * (2^c - 1), 1024 * (2^(c+1) - 1))
+    enum { CHUNK_BITS = 10, CHUNKS = 23 };
+    std::atomic<Entry*> chunks[CHUNKS];
+    std::atomic<uint32_t> count;
+
+    // open addressing indices, slots are 0 if unused
+    struct Index {
+      uint32_t mask;
+      uint32_t used;
+      std::atomic<uint32_t> *ids;
+      std::atomic<uint64_t> *keys;
+      explicit Index(uint32_t n) : mask(n - 1), used(0), ids(0), keys(0) {
+        ids = new std::atomic<uint32_t>[n];
+        keys = new std::atomic<uint64_t>[n];
+        for (uint32_t i = 0; i < n; ++i) {
+          ids[i].store(0, std::memory_order_relaxed);
+          keys[i].store(0, std::memory_order_relaxed);
+        }
+      }
+      ~Index() {
+        delete[] ids;
+        delete[] keys;
+      }
+    };
+    // shape content -> id + 1
+    std::atomic<Index*> shapes;
+    // (id, id) + 1 -> id of the concatenation
+    std::atomic<Index*> pairs;
+    std::atomic<uint32_t> chars[256];
+
+    std::mutex mutex;
+    // replaced indices may still be probed by concurrent readers
+    std::vector<Index*> retired;
+
+    Shape_Table(const Shape_Table&);
+    Shape_Table &operator=(const Shape_Table&);
+
+    static uint64_t mix(uint64_t h) {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      return h ^ (h >> 33);
+    }
+
+    static uint32_t chunk_of(uint32_t id) {
+      return 31 - count_leading_zeroes(uint32_t((id >> CHUNK_BITS) + 1));
+    }
+
+    Entry &entry(uint32_t id) const {
+      uint32_t c = chunk_of(id);
+      Entry *e = chunks[c].load(std::memory_order_acquire);
+      assert(e);
+      return e[id - ((uint32_t(1) << (c + CHUNK_BITS)) - (1u << CHUNK_BITS))];
+    }
+
+    uint32_t find_shape(const Index *x, const F &f, uint64_t h) const {
+      for (uint32_t i = h & x->mask; ; i = (i + 1) & x->mask) {
+        uint32_t s = x->ids[i].load(std::memory_order_acquire);
+        if (!s)
+          return NONE;
+        const Entry &e = entry(s - 1);
+        if (e.hash == h && e.shape == f)
+          return s - 1;
+      }
+    }
+
+    uint32_t find_pair(const Index *x, uint64_t key) const {
+      for (uint32_t i = mix(key) & x->mask; ; i = (i + 1) & x->mask) {
+        uint64_t k = x->keys[i].load(std::memory_order_acquire);
+        if (!k)
+          return NONE;
+        if (k == key)
+          return x->ids[i].load(std::memory_order_relaxed);
+      }
+    }
+
+    // the following functions need the mutex
+
+    static void place_shape(Index *x, uint32_t id, uint64_t h) {
+      uint32_t i = h & x->mask;
+      for (; x->ids[i].load(std::memory_order_relaxed); i = (i + 1) & x->mask) {
+      }
+      x->ids[i].store(id + 1, std::memory_order_release);
+      ++x->used;
+    }
+
+    static void place_pair(Index *x, uint64_t key, uint32_t id) {
+      uint32_t i = mix(key) & x->mask;
+      for (; x->keys[i].load(std::memory_order_relaxed);
+           i = (i + 1) & x->mask) {
+      }
+      x->ids[i].store(id, std::memory_order_relaxed);
+      x->keys[i].store(key, std::memory_order_release);
+      ++x->used;
+    }
+
+    // load factor 1/2
+    Index *grow(std::atomic<Index*> &a, bool pair) {
+      Index *x = a.load(std::memory_order_relaxed);
+      if (2 * (x->used + 1) <= x->mask + 1)
+        return x;
+      Index *y = new Index(2 * (x->mask + 1));
+      if (pair) {
+        for (uint32_t i = 0; i <= x->mask; ++i)
+          if (uint64_t k = x->keys[i].load(std::memory_order_relaxed))
+            place_pair(y, k, x->ids[i].load(std::memory_order_relaxed));
+      } else {
+        uint32_t n = count.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < n; ++i)
+          place_shape(y, i, entry(i).hash);
+      }
+      a.store(y, std::memory_order_release);
+      retired.push_back(x);
+      return y;
+    }
+
+    uint32_t add(const F &f, uint64_t h) {
+      uint32_t id = count.load(std::memory_order_relaxed);
+      assert(id != NONE);
+      uint32_t c = chunk_of(id);
+      assert(c < CHUNKS);
+      if (!chunks[c].load(std::memory_order_relaxed))
+        chunks[c].store(new Entry[size_t(1) << (c + CHUNK_BITS)],
+                        std::memory_order_release);
+      Entry &e = entry(id);
+      e.shape = f;
+      e.hash = h;
+      if (!f.isEmpty()) {
+        e.front = ::front(e.shape);
+        e.back = ::back(e.shape);
+      }
+      count.store(id + 1, std::memory_order_release);
+      return id;
+    }
+
+    Shape_Table() : count(0) {
+#ifdef USE_ARENA
+      // the entries are freed into the arena on exit
+      Arena::registry();
+#endif
+      for (uint32_t i = 0; i < CHUNKS; ++i)
+        chunks[i].store(0, std::memory_order_relaxed);
+      for (uint32_t i = 0; i < 256; ++i)
+        chars[i].store(NONE, std::memory_order_relaxed);
+      shapes.store(new Index(1024), std::memory_order_relaxed);
+      pairs.store(new Index(1024), std::memory_order_relaxed);
+      F f;
+      f.empty();
+      add(f, 0);
+      add(F(), mix(F().hashable_value()));
+      place_shape(shapes.load(std::memory_order_relaxed), NULL_ELEM,
+          entry(NULL_ELEM).hash);
+    }
+
+ public:
+    // constructed after the pools of F, i.e. destructed before them
+    static Shape_Table &instance() {
+      static Shape_Table t;
+      return t;
+    }
+
+    ~Shape_Table() {
+      for (uint32_t i = 0; i < CHUNKS; ++i)
+        delete[] chunks[i].load(std::memory_order_relaxed);
+      delete shapes.load(std::memory_order_relaxed);
+      delete pairs.load(std::memory_order_relaxed);
+      for (typename std::vector<Index*>::iterator i = retired.begin();
+           i != retired.end(); ++i)
+        delete *i;
+    }
+
+    uint32_t size() const {
+      return count.load(std::memory_order_acquire);
+    }
+
+    const F &shape(uint32_t id) const {
+      return entry(id).shape;
+    }
+
+    char front(uint32_t id) const { return entry(id).front; }
+    char back(uint32_t id) const { return entry(id).back; }
+
+    uint32_t intern(const F &f) {
+      if (f.isEmpty())
+        return EMPTY;
+      uint64_t h = mix(f.hashable_value());
+      uint32_t r = find_shape(shapes.load(std::memory_order_acquire), f, h);
+      if (r != NONE)
+        return r;
+      std::lock_guard<std::mutex> lock(mutex);
+      Index *x = shapes.load(std::memory_order_relaxed);
+      r = find_shape(x, f, h);
+      if (r != NONE)
+        return r;
+      x = grow(shapes, false);
+      r = add(f, h);
+      place_shape(x, r, h);
+      return r;
+    }
+
+    uint32_t intern(char c) {
+      std::atomic<uint32_t> &a = chars[static_cast<unsigned char>(c)];
+      uint32_t r = a.load(std::memory_order_acquire);
+      if (r != NONE)
+        return r;
+      F f;
+      f.append(c);
+      r = intern(f);
+      a.store(r, std::memory_order_release);
+      return r;
+    }
+
+    uint32_t concat(uint32_t a, uint32_t b) {
+      assert(a != EMPTY && b != EMPTY);
+      if (b == NULL_ELEM)
+        return a;
+      if (a == NULL_ELEM)
+        return b;
+      uint64_t key = (uint64_t(a) << 32 | b) + 1;
+      uint32_t r = find_pair(pairs.load(std::memory_order_acquire), key);
+      if (r != NONE)
+        return r;
+      F f(shape(a));
+      f.append(shape(b));
+      r = intern(f);
+      std::lock_guard<std::mutex> lock(mutex);
+      if (find_pair(pairs.load(std::memory_order_relaxed), key) == NONE)
+        place_pair(grow(pairs, true), key, r);
+      return r;
+    }
+
+    uint32_t tail(uint32_t id) {
+      std::atomic<uint32_t> &a = entry(id).tail;
+      uint32_t r = a.load(std::memory_order_acquire);
+      if (r != NONE)
+        return r;
+      // concurrent callers compute the same id
+      F f(shape(id));
+      r = intern(::tail(f));
+      a.store(r, std::memory_order_release);
+      return r;
+    }
+};
+
+template <typename F>
+class Interned_Shape {
+ private:
+    typedef Shape_Table<F> Table;
+    uint32_t id;
+
+    static Table &table() { return Table::instance(); }
+
+    void append_id(uint32_t other) {
+      if (isEmpty())
+        id = Table::NULL_ELEM;
+      id = table().concat(id, other);
+    }
+
+ public:
+    typedef typename F::iterator iterator;
+
+    Interned_Shape() : id(Table::NULL_ELEM) {}
+
+    explicit Interned_Shape(char c) : id(table().intern(c)) {}
+
+    explicit Interned_Shape(const char *s) : id(Table::NULL_ELEM) {
+      assert(s);
+      for (; *s; ++s)
+        append(*s);
+    }
+
+    explicit Interned_Shape(const F &f) : id(table().intern(f)) {}
+
+    // dense, i.e. usable as index into tables of size Shape_Table::size()
+    uint32_t index() const { return id; }
+
+    const F &fiber() const { return table().shape(id); }
+
+    bool operator==(char c) const {
+      return id == table().intern(c);
+    }
+
+    bool operator!=(char c) const {
+      return !(*this == c);
+    }
+
+    bool operator==(const Interned_Shape &other) const {
+      return id == other.id;
+    }
+
+    bool operator!=(const Interned_Shape &other) const {
+      return id != other.id;
+    }
+
+    // the lexicographic order of Fiber, i.e. the output order does not
+    // depend on the order in which shapes were interned
+    bool operator<(const Interned_Shape &other) const {
+      if (id == other.id)
+        return false;
+      return fiber() < other.fiber();
+    }
+
+    void append(char c) {
+      append_id(table().intern(c));
+    }
+
+    void append(const Interned_Shape &other) {
+      append_id(other.id);
+    }
+
+    void put(std::ostream &o) const {
+      if (!isEmpty())
+        fiber().put(o);
+    }
+
+    void empty() { id = Table::EMPTY; }
+
+    bool isEmpty() const { return id == Table::EMPTY; }
+
+    uint32_t hashable_value() const {
+      assert(!isEmpty());
+      return id;
+    }
+
+    void swap(Interned_Shape &other) {
+      uint32_t t = id;
+      id = other.id;
+      other.id = t;
+    }
+
+    void move(Interned_Shape &other) {
+      id = other.id;
+      other.id = Table::EMPTY;
+    }
+
+    size_t size() const { return fiber().size(); }
+
+    iterator begin() const { return fiber().begin(); }
+    iterator end() const { return fiber().end(); }
+
+    char front(char r) const {
+      char c = table().front(id);
+      return c ? c : r;
+    }
+
+    char back(char r) const {
+      char c = table().back(id);
+      return c ? c : r;
+    }
+
+    Interned_Shape tail() const {
+      Interned_Shape r;
+      r.id = table().tail(id);
+      return r;
+    }
+};
+
+template <typename F>
+inline
+std::ostream &operator<<(std::ostream &o, const Interned_Shape<F> &f) {
+  f.put(o);
+  return o;
+}
+
+template <typename F>
+inline void append(Interned_Shape<F> &s, const Interned_Shape<F> &x) {
+  s.append(x);
+}
+
+template <typename F>
+inline void append(Interned_Shape<F> &s, char c) {
+  s.append(c);
+}
+
+template <typename F>
+inline void append(Interned_Shape<F> &s, const char *c, int i) {
+  assert(i == 2);
+  s.append(*c);
+  s.append(*(c+1));
+}
+
+template <typename F>
+inline
+Interned_Shape<F> operator+(const Interned_Shape<F> &a,
+    const Interned_Shape<F> &b) {
+  Interned_Shape<F> r(a);
+  r.append(b);
+  return r;
+}
+
+template <typename F>
+inline
+Interned_Shape<F> operator+(const Interned_Shape<F> &a, char b) {
+  Interned_Shape<F> r(a);
+  r.append(b);
+  return r;
+}
+
+template <typename F>
+inline
+Interned_Shape<F> operator+(char a, const Interned_Shape<F> &b) {
+  Interned_Shape<F> r(a);
+  r.append(b);
+  return r;
+}
+
+template <typename F>
+inline
+Interned_Shape<F> operator+(const Interned_Shape<F> &a, const char *b) {
+  Interned_Shape<F> r(a);
+  append(r, b, std::strlen(b));
+  return r;
+}
+
+template <typename F>
+inline
+Interned_Shape<F> operator+(const char *a, const Interned_Shape<F> &b) {
+  Interned_Shape<F> r;
+  append(r, a, std::strlen(a));
+  r.append(b);
+  return r;
+}
+
+template <typename F>
+inline void empty(Interned_Shape<F> &s) {
+  s.empty();
+}
+
+template <typename F>
+inline bool isEmpty(const Interned_Shape<F> &s) {
+  return s.isEmpty();
+}
+
+template <typename F>
+inline uint32_t hashable_value(const Interned_Shape<F> &shape) {
+  return shape.hashable_value();
+}
+
+template <typename F>
+inline void swap(Interned_Shape<F> &a, Interned_Shape<F> &b) {
+  a.swap(b);
+}
+
+template <typename F>
+inline void move(Interned_Shape<F> &a, Interned_Shape<F> &b) {
+  a.move(b);
+}
+
+template <typename F>
+inline
+Interned_Shape<F>
+push_after_front(const Interned_Shape<F> &a, char c, char d) {
+  F f(a.fiber());
+  return Interned_Shape<F>(push_after_front(f, c, d));
+}
+
+template <typename F>
+inline
+Interned_Shape<F> &
+push_before_back(Interned_Shape<F> &a, char c, char d) {
+  F f(a.fiber());
+  a = Interned_Shape<F>(push_before_back(f, c, d));
+  return a;
+}
+
+template <typename F>
+inline char front(const Interned_Shape<F> &a, char r = 0) {
+  return a.front(r);
+}
+
+template <typename F>
+inline char back(const Interned_Shape<F> &a, char r = 0) {
+  return a.back(r);
+}
+
+template <typename F>
+inline Interned_Shape<F> tail(const Interned_Shape<F> &a) {
+  return a.tail();
+}
+
+#endif  // RTLIB_SHAPE_INTERN_HH_
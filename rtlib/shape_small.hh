@@ -0,0 +1,476 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_SHAPE_SMALL_HH_
+#define RTLIB_SHAPE_SMALL_HH_
+
+#ifdef CHECKPOINTING_INTEGRATED
+#error "small shapes (SHAPE_SMALL) do not support checkpointing"
+#endif
+
+#include <cassert>
+#include <cstring>
+#include <ostream>
+
+#include <boost/cstdint.hpp>
+
+// Inline representation of short shapes, selected by SHAPE_SMALL
+// (gapc --small-shapes).
+//
+// A shape of at most CAPACITY symbols of '[', ']' and '_' is stored
+// in one 64 bit word: 2 bit codes from the most significant bit
+// downwards, the length in bits 1-5 and a set bit 0 as tag. All other
+// shapes point to a heap allocated Fiber F (bit 0 is clear, because the
+// pointer is aligned). The representation is canonical, thus
+// concatenation of small shapes is a shift and an or, and neither copies
+// nor classification allocate as long as the shapes stay short.
+
+template <typename F>
+class Small_Shape {
+ public:
+    enum { CAPACITY = 29, LEN_SHIFT = 1, LEN_MASK = 31,
+           SYM_SHIFT = 64 - 2 * CAPACITY };
+
+ private:
+    union {
+      uint64_t word;
+      F *big;
+    };
+
+    static uint64_t code(char c) {
+      switch (c) {
+        case '[' : return 1;
+        case ']' : return 2;
+        case '_' : return 3;
+        default : return 0;
+      }
+    }
+
+    static char to_char(uint64_t c) {
+      static const char chars[] = { 0, '[', ']', '_' };
+      return chars[c];
+    }
+
+    static uint64_t make(uint64_t syms, uint64_t n) {
+      assert(n <= CAPACITY);
+      return syms | n << LEN_SHIFT | 1;
+    }
+
+    bool is_small() const { return word & 1; }
+
+    uint64_t small_length() const {
+      return (word >> LEN_SHIFT) & LEN_MASK;
+    }
+
+    // symbol codes, left aligned
+    uint64_t syms() const {
+      return word & ~uint64_t(0) << SYM_SHIFT;
+    }
+
+    uint64_t code_at(uint64_t i) const {
+      return word >> (62 - 2 * i) & 3;
+    }
+
+    void release() {
+      if (!is_small() && big)
+        delete big;
+    }
+
+    void copy(const Small_Shape &other) {
+      if (other.is_small() || !other.big)
+        word = other.word;
+      else
+        big = new F(*other.big);
+    }
+
+    void spill() {
+      assert(is_small());
+      F *f = new F();
+      for (uint64_t i = 0; i < small_length(); ++i)
+        f->append(to_char(code_at(i)));
+      big = f;
+    }
+
+ public:
+    class Iterator {
+     private:
+        const Small_Shape *s;
+        uint64_t i;
+        typename F::iterator b;
+
+     public:
+        Iterator(const Small_Shape *x, bool end)
+          : s(x), i(0), b(0) {
+          if (s->is_small()) {
+            if (end || !s->small_length())
+              s = 0;
+          } else {
+            b = end ? s->big->end() : s->big->begin();
+          }
+        }
+        Iterator &operator++() {
+          if (s && s->is_small()) {
+            if (++i == s->small_length()) {
+              s = 0;
+              i = 0;
+            }
+          } else {
+            ++b;
+          }
+          return *this;
+        }
+        char operator*() const {
+          if (s && s->is_small())
+            return to_char(s->code_at(i));
+          return *b;
+        }
+        bool operator==(const Iterator &itr) const {
+          return s == itr.s && i == itr.i && b == itr.b;
+        }
+        bool operator!=(const Iterator &itr) const {
+          return !(*this == itr);
+        }
+    };
+
+    typedef Iterator iterator;
+
+    Small_Shape() : word(make(0, 0)) {}
+
+    explicit Small_Shape(char c) : word(make(0, 0)) {
+      append(c);
+    }
+
+    explicit Small_Shape(const char *s) : word(make(0, 0)) {
+      assert(s);
+      for (; *s; ++s)
+        append(*s);
+    }
+
+    explicit Small_Shape(const F &f) : word(make(0, 0)) {
+      if (f.isEmpty()) {
+        word = 0;
+        return;
+      }
+      for (typename F::iterator i = f.begin(); i != f.end(); ++i)
+        append(*i);
+    }
+
+    Small_Shape(const Small_Shape &other) {
+      copy(other);
+    }
+
+    Small_Shape &operator=(const Small_Shape &other) {
+      if (this == &other)
+        return *this;
+      release();
+      copy(other);
+      return *this;
+    }
+
+    ~Small_Shape() {
+      release();
+    }
+
+    bool operator==(char c) const {
+      if (is_small())
+        return word == make(code(c) << 62, 1) && code(c);
+      return big && *big == c;
+    }
+
+    bool operator!=(char c) const {
+      return !(*this == c);
+    }
+
+    bool operator==(const Small_Shape &other) const {
+      if (is_small() || other.is_small() || !big || !other.big)
+        return word == other.word;
+      return *big == *other.big;
+    }
+
+    bool operator!=(const Small_Shape &other) const {
+      return !(*this == other);
+    }
+
+    // lexicographic by character
+    bool operator<(const Small_Shape &other) const {
+      assert(!isEmpty() && !other.isEmpty());
+      if (is_small() && other.is_small())
+        return word < other.word;
+      iterator i = begin(), j = other.begin();
+      for (; i != end() && j != other.end(); ++i, ++j)
+        if (*i != *j)
+          return static_cast<unsigned char>(*i) <
+            static_cast<unsigned char>(*j);
+      return i == end() && j != other.end();
+    }
+
+    void append(char c) {
+      if (isEmpty())
+        word = make(0, 0);
+      if (is_small()) {
+        uint64_t n = small_length();
+        uint64_t x = code(c);
+        if (x && n < CAPACITY) {
+          word = make(syms() | x << (62 - 2 * n), n + 1);
+          return;
+        }
+        spill();
+      }
+      big->append(c);
+    }
+
+    void append(const Small_Shape &other) {
+      assert(!other.isEmpty());
+      if (isEmpty())
+        word = make(0, 0);
+      if (is_small() && other.is_small()) {
+        uint64_t n = small_length();
+        uint64_t m = other.small_length();
+        if (n + m <= CAPACITY) {
+          word = make(syms() | other.syms() >> 2 * n, n + m);
+          return;
+        }
+      }
+      if (is_small())
+        spill();
+      if (other.is_small()) {
+        for (iterator i = other.begin(); i != other.end(); ++i)
+          big->append(*i);
+      } else {
+        big->append(*other.big);
+      }
+    }
+
+    void put(std::ostream &o) const {
+      for (iterator i = begin(); i != end(); ++i)
+        o << *i;
+    }
+
+    void empty() {
+      release();
+      word = 0;
+    }
+
+    bool isEmpty() const {
+      return !word;
+    }
+
+    uint32_t hashable_value() const {
+      assert(!isEmpty());
+      if (!is_small())
+        return big->hashable_value();
+      uint64_t h = word * 0x9e3779b97f4a7c15ULL;
+      return uint32_t(h >> 32);
+    }
+
+    void swap(Small_Shape &other) {
+      uint64_t t = word;
+      word = other.word;
+      other.word = t;
+    }
+
+    void move(Small_Shape &other) {
+      release();
+      word = other.word;
+      other.word = 0;
+    }
+
+    size_t size() const {
+      return is_small() ? small_length() : big->size();
+    }
+
+    iterator begin() const { return iterator(this, false); }
+    iterator end() const { return iterator(this, true); }
+
+    char front(char r) const {
+      if (is_small())
+        return small_length() ? to_char(code_at(0)) : r;
+      return ::front(*big, r);
+    }
+
+    char back(char r) const {
+      if (is_small())
+        return small_length() ? to_char(code_at(small_length() - 1)) : r;
+      return ::back(*big, r);
+    }
+
+    Small_Shape tail() const {
+      Small_Shape r;
+      if (is_small()) {
+        if (small_length())
+          r.word = make(syms() << 2, small_length() - 1);
+        return r;
+      }
+      iterator i = begin();
+      if (i != end())
+        ++i;
+      for (; i != end(); ++i)
+        r.append(*i);
+      return r;
+    }
+};
+
+template <typename F>
+inline
+std::ostream &operator<<(std::ostream &o, const Small_Shape<F> &f) {
+  f.put(o);
+  return o;
+}
+
+template <typename F>
+inline void append(Small_Shape<F> &s, const Small_Shape<F> &x) {
+  s.append(x);
+}
+
+template <typename F>
+inline void append(Small_Shape<F> &s, char c) {
+  s.append(c);
+}
+
+template <typename F>
+inline void append(Small_Shape<F> &s, const char *c, int i) {
+  assert(i == 2);
+  s.append(*c);
+  s.append(*(c+1));
+}
+
+template <typename F>
+inline
+Small_Shape<F> operator+(const Small_Shape<F> &a, const Small_Shape<F> &b) {
+  Small_Shape<F> r(a);
+  r.append(b);
+  return r;
+}
+
+template <typename F>
+inline
+Small_Shape<F> operator+(const Small_Shape<F> &a, char b) {
+  Small_Shape<F> r(a);
+  r.append(b);
+  return r;
+}
+
+template <typename F>
+inline
+Small_Shape<F> operator+(char a, const Small_Shape<F> &b) {
+  Small_Shape<F> r(a);
+  r.append(b);
+  return r;
+}
+
+template <typename F>
+inline
+Small_Shape<F> operator+(const Small_Shape<F> &a, const char *b) {
+  Small_Shape<F> r(a);
+  append(r, b, std::strlen(b));
+  return r;
+}
+
+template <typename F>
+inline
+Small_Shape<F> operator+(const char *a, const Small_Shape<F> &b) {
+  Small_Shape<F> r;
+  append(r, a, std::strlen(a));
+  r.append(b);
+  return r;
+}
+
+template <typename F>
+inline void empty(Small_Shape<F> &s) {
+  s.empty();
+}
+
+template <typename F>
+inline bool isEmpty(const Small_Shape<F> &s) {
+  return s.isEmpty();
+}
+
+template <typename F>
+inline uint32_t hashable_value(const Small_Shape<F> &shape) {
+  return shape.hashable_value();
+}
+
+template <typename F>
+inline void swap(Small_Shape<F> &a, Small_Shape<F> &b) {
+  a.swap(b);
+}
+
+template <typename F>
+inline void move(Small_Shape<F> &a, Small_Shape<F> &b) {
+  a.move(b);
+}
+
+// inserts d after the leading run of c
+template <typename F>
+inline
+Small_Shape<F> push_after_front(const Small_Shape<F> &a, char c, char d) {
+  Small_Shape<F> r;
+  typename Small_Shape<F>::iterator i = a.begin();
+  for (; i != a.end() && *i == c; ++i)
+    r.append(c);
+  r.append(d);
+  for (; i != a.end(); ++i)
+    r.append(*i);
+  return r;
+}
+
+// inserts d before the trailing run of c
+template <typename F>
+inline
+Small_Shape<F> &push_before_back(Small_Shape<F> &a, char c, char d) {
+  size_t n = a.size();
+  size_t k = n;
+  size_t p = 0;
+  for (typename Small_Shape<F>::iterator i = a.begin(); i != a.end();
+       ++i, ++p)
+    if (*i != c)
+      k = n;
+    else if (k == n)
+      k = p;
+  Small_Shape<F> r;
+  typename Small_Shape<F>::iterator i = a.begin();
+  for (p = 0; p < k; ++p, ++i)
+    r.append(*i);
+  r.append(d);
+  for (; i != a.end(); ++i)
+    r.append(*i);
+  a = r;
+  return a;
+}
+
+template <typename F>
+inline char front(const Small_Shape<F> &a, char r = 0) {
+  return a.front(r);
+}
+
+template <typename F>
+inline char back(const Small_Shape<F> &a, char r = 0) {
+  return a.back(r);
+}
+
+template <typename F>
+inline Small_Shape<F> tail(const Small_Shape<F> &a) {
+  return a.tail();
+}
+
+#endif  // RTLIB_SHAPE_SMALL_HH_
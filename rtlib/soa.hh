@@ -0,0 +1,125 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_SOA_HH_
+#define RTLIB_SOA_HH_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Struct of arrays storage for the answers of a table.
+//
+// Each component of a std::pair answer (i.e. of a product answer with a
+// fixed width of one) lives in its own contiguous array, nested pairs are
+// split recursively. Thus, a scan over the primary score of a table only
+// touches score memory. Every other answer type is stored like in a
+// std::vector.
+
+namespace Table {
+
+template <typename T>
+class Soa {
+ private:
+    std::vector<T> array;
+
+ public:
+    typedef T &reference;
+    typedef const T &const_reference;
+
+    void resize(size_t n) { array.resize(n); }
+    void clear() { array.clear(); }
+    void shrink_to_fit() { array.shrink_to_fit(); }
+    size_t size() const { return array.size(); }
+
+    reference operator[](size_t i) { return array[i]; }
+    const_reference operator[](size_t i) const { return array[i]; }
+};
+
+template <typename A, typename B>
+class Soa_Ref {
+ public:
+    typedef typename Soa<A>::reference first_type;
+    typedef typename Soa<B>::reference second_type;
+
+    first_type first;
+    second_type second;
+
+    Soa_Ref(first_type a, second_type b) : first(a), second(b) {}
+
+    Soa_Ref &operator=(const std::pair<A, B> &x) {
+      first = x.first;
+      second = x.second;
+      return *this;
+    }
+
+    Soa_Ref &operator=(const Soa_Ref &x) {
+      return *this = std::pair<A, B>(x);
+    }
+
+    operator std::pair<A, B>() const {
+      return std::pair<A, B>(first, second);
+    }
+};
+
+template <typename A, typename B>
+class Soa<std::pair<A, B> > {
+ private:
+    Soa<A> first_;
+    Soa<B> second_;
+
+ public:
+    typedef Soa_Ref<A, B> reference;
+    typedef std::pair<A, B> const_reference;
+
+    void resize(size_t n) {
+      first_.resize(n);
+      second_.resize(n);
+    }
+    void clear() {
+      first_.clear();
+      second_.clear();
+    }
+    void shrink_to_fit() {
+      first_.shrink_to_fit();
+      second_.shrink_to_fit();
+    }
+    size_t size() const { return first_.size(); }
+
+    reference operator[](size_t i) {
+      return reference(first_[i], second_[i]);
+    }
+    const_reference operator[](size_t i) const {
+      return const_reference(first_[i], second_[i]);
+    }
+
+    // component arrays, e.g. for scans over the primary score only
+    Soa<A> &first() { return first_; }
+    const Soa<A> &first() const { return first_; }
+    Soa<B> &second() { return second_; }
+    const Soa<B> &second() const { return second_; }
+};
+
+}  // namespace Table
+
+#endif  // RTLIB_SOA_HH_
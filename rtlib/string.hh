@@ -26,6 +26,7 @@
 #define RTLIB_STRING_HH_
 
 #include <new>
+#include <atomic>
 #include <cassert>
 #include <cstring>
 #include <utility>
@@ -73,16 +74,20 @@ class String {
        }
 #endif
         void del(Block *b) {
-          assert(b->ref_count);
-          b->dec_ref();
-          if (!b->ref_count)
+          if (b->dec_ref())
             delete b;
         }
 
         Block &operator=(const Block &b);
 
      public:
+#ifdef _OPENMP
+      // copies of a String in the table cells of other threads (parallel
+      // CYK, parallel Pareto fronts) share its blocks
+      std::atomic<uint32_t> ref_count;
+#else
       uint32_t ref_count;
+#endif
 
       // total size of object should be 64 bytes
       // (refcount: 4 bytes, pos: 1 byte, array: 59 bytes -> 64 bytes total)
@@ -175,7 +180,8 @@ class String {
       }
 
       void inc_ref() { ref_count++; }
-      void dec_ref() { assert(ref_count > 0); ref_count--; }
+      // true, if the last reference was dropped
+      bool dec_ref() { assert(ref_count > 0); return !--ref_count; }
 
       void append(char c) {
         assert(pos + 3 <= size);
@@ -243,9 +249,7 @@ class String {
       if (!block) {
         return;
       }
-      assert(block->ref_count);
-      block->dec_ref();
-      if (!block->ref_count) {
+      if (block->dec_ref()) {
         delete block;
         block = NULL;
 #if defined(CHECKPOINTING_INTEGRATED)
@@ -28,12 +28,15 @@
 
 #include "table.hh"
 
+// Cells of a non-terminal that --subopt-classify has to compute in the
+// second phase. Rows are allocated on their first mark, i.e. a
+// non-terminal (or a row of it) that is never reached by the marking
+// backtrace costs one empty vector per row.
 template <typename pos_type = unsigned int>
 class Marker {
  private:
     pos_type n;
-    std::vector<bool> array;
-    Table::DiagIndex<pos_type> index;
+    std::vector<std::vector<bool> > rows;
 
  public:
     Marker()
@@ -42,31 +45,26 @@ class Marker {
 
     void init(pos_type x) {
       n = x;
-      pos_type t = index(n);
-      array.resize(t);
+      rows.clear();
+      rows.resize(n + 1);
     }
 
     void set(pos_type i, pos_type j) {
-      assert(i <= n);
+      assert(i <= j);
       assert(j <= n);
 
-      pos_type t = index(i, j, n);
-
-      assert(t < array.size());
-
-      array[t] = true;
+      std::vector<bool> &row = rows[i];
+      if (row.empty())
+        row.resize(n - i + 1);
+      row[j - i] = true;
     }
 
     bool is_set(pos_type i, pos_type j) const {
-      assert(i <= n);
+      assert(i <= j);
       assert(j <= n);
 
-      pos_type t = index(i, j, n);
-
-      assert(t < array.size());
-
-      bool r = array[t];
-      return r;
+      const std::vector<bool> &row = rows[i];
+      return !row.empty() && row[j - i];
     }
 };
 
@@ -177,6 +175,156 @@ inline void append_min_subopt(List_Ref<T, pos_int> &x, List_Ref<T, pos_int> &e,
 }
 
 
+// --subopt-stream
+//
+// Wuchty style enumeration: a candidate is a backtrace whose unexpanded
+// sub-problems are Backtrace_Slot leaves. The enumeration expands the slots
+// depth first, i.e. it plugs in one alternative of the sub-problem after the
+// other and descends with the remaining energy budget - a complete candidate
+// is printed right away and forgotten afterwards. Thus, working memory only
+// consists of the current candidate plus one alternative list per open
+// expansion.
+
+template <typename Score, typename Value, typename pos_int>
+class Backtrace_Slot : public Backtrace<Value, pos_int> {
+ public:
+    typedef std::pair<Score, intrusive_ptr<Backtrace<Value, pos_int> > >
+      alt_t;
+
+    // optimal score of the sub-problem
+    Score score;
+
+    explicit Backtrace_Slot(const Score &s) : score(s) {}
+
+    // appends the alternatives of the sub-problem which are at most delta
+    // worse than its optimum, their own sub-problems are slots again
+    virtual void expand(std::vector<alt_t> &alts, const Score &global_score,
+                        const Score &delta) = 0;
+
+    intrusive_ptr<Eval_List<Value> > eval() { assert(0); return 0; }
+};
+
+template <typename T, typename ref_int, typename A>
+inline void slot_alternatives(std::vector<A> &alts, List_Ref<T, ref_int> l) {
+  if (isEmpty(l))
+    return;
+  alts.insert(alts.end(), l.ref().begin(), l.ref().end());
+}
+
+template <typename A>
+inline void slot_alternatives(std::vector<A> &alts, A x) {
+  if (isEmpty(x))
+    return;
+  alts.push_back(x);
+}
+
+template <typename Score, typename Value, typename pos_int>
+class Subopt_Stream {
+ public:
+    typedef intrusive_ptr<Backtrace<Value, pos_int> > bt_t;
+    typedef Backtrace_Slot<Score, Value, pos_int> slot_t;
+    typedef typename slot_t::alt_t alt_t;
+
+ private:
+    struct Open {
+      bt_t *where;
+      bt_t proxy;
+      slot_t *slot;
+
+      Open(bt_t *w, slot_t *s) : where(w), proxy(*w), slot(s) {}
+    };
+
+    Score global_score;
+    bt_t root;
+    std::vector<Open> open;
+
+    static Score distance(const Score &a, const Score &b) {
+      return a < b ? b - a : a - b;
+    }
+
+    void collect(bt_t *where) {
+      slot_t *s = dynamic_cast<slot_t*>(where->get());
+      if (s) {
+        open.push_back(Open(where, s));
+        return;
+      }
+      std::vector<bt_t*> l;
+      (*where)->subtrees(l);
+      for (typename std::vector<bt_t*>::iterator i = l.begin();
+           i != l.end(); ++i)
+        collect(*i);
+    }
+
+    // nodes are reused for several candidates, thus their memoised
+    // evaluations are stale
+    static void forget(const bt_t &x) {
+      x->evaluated.reset();
+      std::vector<bt_t*> l;
+      x->subtrees(l);
+      for (typename std::vector<bt_t*>::iterator i = l.begin();
+           i != l.end(); ++i)
+        forget(**i);
+    }
+
+    template <typename Emit>
+    void descend(const Score &score, const Score &slack, Emit &emit) {
+      if (open.empty()) {
+        forget(root);
+        emit(score, root);
+        return;
+      }
+      Open o = open.back();
+      open.pop_back();
+      std::vector<alt_t> alts;
+      o.slot->expand(alts, global_score, slack);
+      for (typename std::vector<alt_t>::iterator i = alts.begin();
+           i != alts.end(); ++i) {
+        Score cost = distance((*i).first, o.slot->score);
+        if (slack < cost)
+          continue;
+        *o.where = (*i).second;
+        size_t mark = open.size();
+        collect(o.where);
+        descend(score + ((*i).first - o.slot->score), slack - cost, emit);
+        open.erase(open.begin() + mark, open.end());
+        (*i).second.reset();
+      }
+      *o.where = o.proxy;
+      open.push_back(o);
+    }
+
+ public:
+    explicit Subopt_Stream(const Score &g) : global_score(g) {}
+
+    template <typename Emit>
+    void run(const alt_t &start, const Score &delta, Emit &emit) {
+      Score cost = distance(start.first, global_score);
+      if (delta < cost)
+        return;
+      root = start.second;
+      open.clear();
+      collect(&root);
+      descend(start.first, delta - cost, emit);
+      root.reset();
+    }
+};
+
+// calls emit(score, backtrace) for every candidate within delta of
+// global_score, starting from the slots of the axiom
+template <typename Score, typename Value, typename pos_int, typename ref_int,
+          typename Emit>
+inline void subopt_stream(
+    List_Ref<std::pair<Score, intrusive_ptr<Backtrace<Value, pos_int> > >,
+             ref_int> roots,
+    const Score &global_score, const Score &delta, Emit emit) {
+  typedef typename Subopt_Stream<Score, Value, pos_int>::alt_t alt_t;
+  Subopt_Stream<Score, Value, pos_int> s(global_score);
+  std::vector<alt_t> l;
+  slot_alternatives(l, roots);
+  for (typename std::vector<alt_t>::iterator i = l.begin(); i != l.end(); ++i)
+    s.run(*i, delta, emit);
+}
+
 // FIXME push_back_max_subopt ...
 // FIXME add other subopt fns
 
@@ -0,0 +1,333 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#ifndef RTLIB_TOP_K_HH_
+#define RTLIB_TOP_K_HH_
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "empty.hh"
+#include "erase.hh"
+#include "list.hh"
+
+// Streaming top-k kernel behind the kminimum/kmaximum choice functions.
+//
+// With a single (k)scoring algebra, gapc pushes candidates via
+// push_back_kmin/push_back_kmax instead of collecting all of them: the
+// answer list is kept as a binary heap of at most k elements whose front
+// is the worst retained candidate. Thus, a candidate that is not better
+// than the front of a full heap is rejected in O(1) and the choice
+// function only has to sort the k survivors.
+
+struct Top_K {
+  static uint32_t &size() {
+    static uint32_t k = 3;
+    return k;
+  }
+  static void set(uint32_t k) {
+    size() = k;
+  }
+};
+
+template<class T, typename pos_int, typename Cmp>
+inline void push_back_top_k(List_Ref<T, pos_int> &x, T &e, Cmp cmp) {
+  assert(!isEmpty(e));
+  uint32_t k = Top_K::size();
+  if (!k) {
+    erase(e);
+    return;
+  }
+  List<T, pos_int> &l = x.ref();
+  if (l.size() < k) {
+    l.push_back(e);
+    std::push_heap(l.begin(), l.end(), cmp);
+    return;
+  }
+  // early rejection
+  if (!cmp(e, l.front())) {
+    erase(e);
+    return;
+  }
+  std::pop_heap(l.begin(), l.end(), cmp);
+  erase(l.back());
+  l.back() = e;
+  std::push_heap(l.begin(), l.end(), cmp);
+}
+
+template<class T, typename pos_int>
+inline void push_back_kmin(List_Ref<T, pos_int> &x, T &e) {
+  push_back_top_k(x, e, std::less<T>());
+}
+
+template<class T, typename pos_int>
+inline void push_back_kmax(List_Ref<T, pos_int> &x, T &e) {
+  push_back_top_k(x, e, std::greater<T>());
+}
+
+template<class T, typename pos_int>
+inline void append_kmin(List_Ref<T, pos_int> &x, List_Ref<T, pos_int> &e) {
+  if (isEmpty(e))
+    return;
+  assert(&x.ref() != &e.ref());
+  List<T, pos_int> &l = e.ref();
+  for (typename List<T, pos_int>::iterator i = l.begin(); i != l.end(); ++i)
+    push_back_kmin(x, *i);
+}
+
+template<class T, typename pos_int>
+inline void append_kmax(List_Ref<T, pos_int> &x, List_Ref<T, pos_int> &e) {
+  if (isEmpty(e))
+    return;
+  assert(&x.ref() != &e.ref());
+  List<T, pos_int> &l = e.ref();
+  for (typename List<T, pos_int>::iterator i = l.begin(); i != l.end(); ++i)
+    push_back_kmax(x, *i);
+}
+
+// --lazy-kbest: the candidates of an alternative with several sub-answer
+// lists, e.g. f(x, y) over the k best x and the k best y, in best-first
+// order instead of the whole cross product (Huang and Chiang, lazy k-best
+// extraction). The index vector c stands for f(l_0[c_0], ..., l_n[c_n]) of
+// the sorted lists. The evaluation of (0, ..., 0) starts the frontier; the
+// best candidate on the frontier is popped and its successors c + e_d are
+// evaluated, until k candidates are popped. A successor is only generated
+// by its single predecessor - the one with the last non-zero index
+// decremented - such that no index vector is visited twice. Thus, about
+// k * n instead of k^n candidates are evaluated. The result is exact if the
+// algebra functions are monotone in their list arguments.
+//
+//   Top_K_Frontier f(answers, std::less<>(), 2);
+//   f.dim(0, xs); f.dim(1, ys);
+//   while (f.next()) {
+//     ans = fn(f.at(0, xs), f.at(1, ys));
+//     f.push_back(answers, ans);
+//   }
+//
+// A candidate without push_back, e.g. because of a filter, does not enter
+// the frontier, but its successors are evaluated right away.
+template<class T, typename Cmp>
+class Top_K_Frontier {
+ private:
+  typedef std::vector<uint32_t> index;
+
+  struct Candidate {
+    T value;
+    index c;
+    Candidate(const T &v, const index &i) : value(v), c(i) {}
+  };
+
+  struct Worse {
+    Cmp cmp;
+    explicit Worse(Cmp c) : cmp(c) {}
+    bool operator()(const Candidate &a, const Candidate &b) const {
+      return cmp(b.value, a.value);
+    }
+  };
+
+  Cmp cmp;
+  // per list: the element positions in best-first order
+  std::vector<std::vector<uint32_t> > order;
+  std::vector<Candidate> frontier;
+  std::vector<index> pending;
+  index current;
+  bool started;
+  bool pushed;
+  uint32_t popped;
+
+  void expand(const index &c) {
+    size_t d = c.size();
+    while (d > 0 && !c[d-1])
+      --d;
+    for (d = d ? d-1 : 0; d < c.size(); ++d) {
+      if (c[d] + 1 >= order[d].size())
+        continue;
+      pending.push_back(c);
+      ++pending.back()[d];
+    }
+  }
+
+ public:
+  template<typename pos_int>
+  Top_K_Frontier(const List_Ref<T, pos_int> &answers, Cmp c, size_t n)
+    : cmp(c), order(n), current(n, 0), started(false), pushed(false),
+      popped(0) {
+  }
+
+  template<class E, typename pos_int>
+  void dim(size_t d, List_Ref<E, pos_int> &l) {
+    std::vector<uint32_t> &o = order[d];
+    o.clear();
+    if (isEmpty(l))
+      return;
+    List<E, pos_int> &x = l.ref();
+    for (uint32_t i = 0; i < x.size(); ++i)
+      o.push_back(i);
+    // the sub-answer lists of kminimum/kmaximum are already sorted
+    std::stable_sort(o.begin(), o.end(),
+        [&x, this](uint32_t a, uint32_t b) { return cmp(x[a], x[b]); });
+  }
+
+  // a single sub-answer instead of a list
+  template<class E>
+  void dim(size_t d, const E &) {
+    order[d].assign(1, 0);
+  }
+
+  template<class E, typename pos_int>
+  E &at(size_t d, List_Ref<E, pos_int> &l) {
+    return l.ref()[order[d][current[d]]];
+  }
+
+  template<class E>
+  const E &at(size_t d, const E &e) const {
+    return e;
+  }
+
+  bool next() {
+    if (!started) {
+      started = true;
+      for (size_t d = 0; d < order.size(); ++d)
+        if (order[d].empty())
+          return false;
+      pending.push_back(current);
+    } else if (!pushed) {
+      expand(current);
+    }
+    while (pending.empty()) {
+      if (frontier.empty() || popped >= Top_K::size())
+        return false;
+      std::pop_heap(frontier.begin(), frontier.end(), Worse(cmp));
+      expand(frontier.back().c);
+      frontier.pop_back();
+      ++popped;
+    }
+    current.swap(pending.back());
+    pending.pop_back();
+    pushed = false;
+    return true;
+  }
+
+  template<typename pos_int>
+  void push_back(List_Ref<T, pos_int> &answers, T &e) {
+    frontier.push_back(Candidate(e, current));
+    std::push_heap(frontier.begin(), frontier.end(), Worse(cmp));
+    pushed = true;
+    push_back_top_k(answers, e, cmp);
+  }
+};
+
+// the choice functions themselves: k best candidates in sorted order
+
+template <typename Iterator, typename Cmp>
+inline
+List_Ref<typename std::iterator_traits<Iterator>::value_type>
+top_k(Iterator begin, Iterator end, Cmp cmp) {
+  typedef typename std::iterator_traits<Iterator>::value_type type;
+  std::vector<type> v(begin, end);
+  size_t k = std::min(size_t(Top_K::size()), v.size());
+  std::partial_sort(v.begin(), v.begin() + k, v.end(), cmp);
+  List_Ref<type> ret;
+  for (size_t i = 0; i < k; ++i)
+    push_back(ret, v[i]);
+  return ret;
+}
+
+template <typename Iterator>
+inline
+List_Ref<typename std::iterator_traits<Iterator>::value_type>
+kminimum(std::pair<Iterator, Iterator> &p) {
+  typedef typename std::iterator_traits<Iterator>::value_type type;
+  return top_k(p.first, p.second, std::less<type>());
+}
+
+template <typename Iterator>
+inline
+List_Ref<typename std::iterator_traits<Iterator>::value_type>
+kmaximum(std::pair<Iterator, Iterator> &p) {
+  typedef typename std::iterator_traits<Iterator>::value_type type;
+  return top_k(p.first, p.second, std::greater<type>());
+}
+
+// Product choice of a kscoring algebra with a pretty printing one (e.g.
+// under --kbacktrace): the candidates of each of the k classes, in class
+// order and in input order within a class. Instead of one pass over all
+// candidates per class, i.e. O(k n), each candidate looks up its class by
+// binary search: O(n log k). With one_per_class (--no-coopt-class) only
+// the first candidate of each class is kept.
+template<class T, typename pos_int, typename Iterator, class S,
+         typename pos_int2>
+inline void join_classes(List_Ref<T, pos_int> &answers,
+    Iterator begin, Iterator end, List_Ref<S, pos_int2> &classes,
+    bool one_per_class) {
+  if (isEmpty(classes))
+    return;
+  List<S, pos_int2> &c = classes.ref();
+  std::vector<S> keys(c.begin(), c.end());
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  std::vector<std::vector<Iterator> > members(keys.size());
+  for (Iterator i = begin; i != end; ++i) {
+    typename std::vector<S>::iterator k =
+      std::lower_bound(keys.begin(), keys.end(), (*i).first);
+    if (k == keys.end() || (*i).first < *k)
+      continue;
+    std::vector<Iterator> &m = members[k - keys.begin()];
+    if (one_per_class && !m.empty())
+      continue;
+    m.push_back(i);
+  }
+  for (typename List<S, pos_int2>::iterator i = c.begin(); i != c.end();
+       ++i) {
+    std::vector<Iterator> &m = members[
+      std::lower_bound(keys.begin(), keys.end(), *i) - keys.begin()];
+    for (typename std::vector<Iterator>::iterator j = m.begin(); j != m.end();
+         ++j)
+      push_back(answers, **j);
+  }
+}
+
+template<class T, typename pos_int, typename Iterator, class S,
+         typename pos_int2>
+inline void join_classes(List_Ref<T, pos_int> &answers,
+    std::pair<Iterator, Iterator> &candidates, List_Ref<S, pos_int2> &classes,
+    bool one_per_class) {
+  join_classes(answers, candidates.first, candidates.second, classes,
+               one_per_class);
+}
+
+template<class T, typename pos_int, class S, typename pos_int2>
+inline void join_classes(List_Ref<T, pos_int> &answers,
+    List_Ref<T, pos_int> &candidates, List_Ref<S, pos_int2> &classes,
+    bool one_per_class) {
+  if (isEmpty(candidates))
+    return;
+  join_classes(answers, candidates.ref().begin(), candidates.ref().end(),
+               classes, one_per_class);
+}
+
+#endif  // RTLIB_TOP_K_HH_
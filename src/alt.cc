@@ -45,6 +45,7 @@
 
 #include "ast.hh"
 #include "instance.hh"
+#include "product.hh"
 
 #include "statement/fn_call.hh"
 
@@ -68,7 +69,7 @@ Alt::Base::~Base() {
 
 Alt::Simple::Simple(std::string *n, const Loc &l)
   :  Base(SIMPLE, l), is_terminal_(false),
-    name(n), decl(NULL), guards(NULL), inner_code(0) {
+    name(n), decl(NULL), kbest_push(NULL), guards(NULL), inner_code(0) {
   hashtable<std::string, Fn_Decl*>::iterator j = Fn_Decl::builtins.find(*name);
   if (j != Fn_Decl::builtins.end()) {
     is_terminal_ = true;
@@ -1359,6 +1360,39 @@ void Alt::Simple::init_foreach() {
 }
 
 
+// --lazy-kbest: the candidates of the nested foreach loops over the sorted
+// sub-answer lists are pushed into a kminimum/kmaximum list, i.e. only the
+// k best of them are kept. Instead of the cross product, the loops are
+// printed as best first enumeration through a Top_K_Frontier
+// (rtlib/top_k.hh), which evaluates about k candidates per list.
+void Alt::Simple::lazy_kbest() {
+  if (!kbest_push || kbest_push->is_obj) {
+    return;
+  }
+  for (std::list<Statement::Foreach*>::iterator i = foreach_loops.begin();
+       i != foreach_loops.end(); ++i) {
+    if ((*i)->elem->is_itr()) {
+      return;
+    }
+    std::list<Statement::Foreach*>::iterator j = i;
+    ++j;
+    if (j != foreach_loops.end() && ((*i)->statements.size() != 1 ||
+        (*i)->statements.front() != *j)) {
+      return;
+    }
+  }
+  Statement::Var_Decl *frontier = new Statement::Var_Decl(
+    new ::Type::External("Top_K_Frontier"),
+    new std::string(*ret_decl->name + "_kbest"));
+  Statement::Foreach *outer = foreach_loops.front();
+  outer->frontier = frontier;
+  outer->frontier_answers = ret_decl;
+  // push_back(ret, ans) -> ret_kbest.push_back(ret, ans)
+  kbest_push->args.push_front(new Expr::Vacc(*frontier));
+  kbest_push->is_obj = Bool(true);
+}
+
+
 void Alt::Simple::ret_decl_empty_block(Statement::If *stmt) {
   if (!datatype->simple()->is(::Type::LIST)) {
     Statement::Fn_Call *e = new Statement::Fn_Call(Statement::Fn_Call::EMPTY);
@@ -1461,6 +1495,7 @@ void Alt::Base::add_seqs(Expr::Fn_Call *fn_call, const AST &ast) const {
 
 void Alt::Simple::init_body(AST &ast) {
   body_stmts.clear();
+  kbest_push = NULL;
 
   std::list<Statement::Base*> *stmts = &body_stmts;
   add_with_overlay_code(stmts, ast);
@@ -1516,13 +1551,41 @@ void Alt::Simple::init_body(AST &ast) {
       Statement::Fn_Call::PUSH_BACK);
     fn->add_arg(*ret_decl);
     fn->add_arg(*vdecl);
-    stmts->push_back(vdecl);
+    kbest_push = fn;
     Expr::Base *suchthat = suchthat_code(*vdecl);
-    if (suchthat) {
+    ::Type::Tuple *tuple =
+      dynamic_cast< ::Type::Tuple*>(decl->return_type->simple());
+    if (!suchthat && tuple && n != name &&
+        ast.instance_->product->lazy() &&
+        Fn_Decl::builtins.find(*name) == Fn_Decl::builtins.end()) {
+      // the right component is only computed, if the left one is not
+      // already beaten by the candidates collected so far
+      Expr::Fn_Call *left_call = new Expr::Fn_Call(
+        new std::string(*n + "_left"));
+      left_call->add(fn_call->exprs);
+      Statement::Var_Decl *left = new Statement::Var_Decl(
+        tuple->left(), new std::string("ans_left"), left_call);
+      stmts->push_back(left);
+      Expr::Fn_Call *survives = new Expr::Fn_Call(Expr::Fn_Call::SURVIVES);
+      survives->add_arg(*ret_decl);
+      survives->add_arg(*left);
+      // and reused for the complete candidate
+      Expr::Fn_Call *right_call = new Expr::Fn_Call(
+        new std::string(*n + "_right"));
+      right_call->add_arg(*left);
+      right_call->add(fn_call->exprs);
+      vdecl->rhs = right_call;
+      Statement::If *c = new Statement::If(survives);
+      c->then.push_back(vdecl);
+      c->then.push_back(fn);
+      stmts->push_back(c);
+    } else if (suchthat) {
+      stmts->push_back(vdecl);
       Statement::If *c = new Statement::If(suchthat);
       c->then.push_back(fn);
       stmts->push_back(c);
     } else {
+      stmts->push_back(vdecl);
       stmts->push_back(fn);
     }
   } else {
@@ -2012,6 +2075,11 @@ void Alt::Simple::codegen(AST &ast) {
     loop_body = &f->statements;
   }
   init_body(ast);
+  // the push type is only known after optimize_choice, see lazy_kbest()
+  if (!ast.lazy_kbest || ast.code_mode() != Code::Mode::FORWARD ||
+      adp_specialization != ADP_Mode::STANDARD || foreach_loops.size() < 2) {
+    kbest_push = NULL;
+  }
   if (!disabled_spec && !nullary && answer_list &&
      adp_specialization != ADP_Mode::STANDARD) {
       std::list<Statement::Base*> *app_stmts;
@@ -2255,12 +2323,14 @@ void Alt::Block::codegen(AST &ast) {
       }
     }
   }
+  // also moves a --pareto-stream front into the list, e.g. of a block
+  // argument f(x, {a | b}) the enclosing foreach iterates over
   if (datatype->simple()->is(::Type::LIST)) {
     if (!ret_decl->rhs && adp_specialization == ADP_Mode::STANDARD) {
       Statement::Fn_Call *f = new Statement::Fn_Call(
         Statement::Fn_Call::FINALIZE);
       f->add_arg(*ret_decl);
-      stmts->push_back(f);
+      statements.push_back(f);
     }
   }
        // std::cout << "-----------------End Block " << std::endl;
@@ -2389,6 +2459,10 @@ void Alt::Base::optimize_choice(::Type::List::Push_Type push) {
   ::Type::List *l = dynamic_cast< ::Type::List*>(ret_decl->type);
   assert(l);
   l->set_push_type(push);
+  if (is(SIMPLE) &&
+      (push == ::Type::List::KMIN || push == ::Type::List::KMAX)) {
+    dynamic_cast<Simple*>(this)->lazy_kbest();
+  }
 }
 
 
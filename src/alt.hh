@@ -433,6 +433,9 @@ class Simple : public Base {
  private:
   std::list<Statement::Foreach *> foreach_loops;
   std::list<Statement::Base*> body_stmts;
+  // push of the candidate in the innermost foreach loop, if the loops may
+  // enumerate best first (--lazy-kbest)
+  Statement::Fn_Call *kbest_push;
 
   Statement::If *guards;
   Statement::If *guards_outside;
@@ -472,6 +475,7 @@ class Simple : public Base {
 
   void init_foreach();
   bool has_arg_list();
+  void lazy_kbest();
   void init_body(AST &ast);
   void init_guards();
   void init_outside_guards();
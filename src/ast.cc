@@ -24,6 +24,7 @@
 #include <cassert>
 #include <sstream>
 #include <map>
+#include <set>
 #include <algorithm>
 
 #include "ast.hh"
@@ -192,6 +193,56 @@ Instance *AST::instance(const std::string &n) {
 }
 
 
+/*
+ * Joins the products of several instances into a single instance, i.e.
+ * one grammar traversal computes the answers of all instances. Each
+ * table cell holds a tuple with one answer per instance and the choice
+ * functions of the instances stay independent. Thus, every instance
+ * must yield a single answer per sub-problem, like mfe, pf or count do.
+ */
+Instance *AST::fuse_instances(const std::vector<std::string> &names) {
+  std::vector<Instance*> l;
+  std::set<Algebra*> seen;
+  for (std::vector<std::string>::const_iterator i = names.begin();
+       i != names.end(); ++i) {
+    Instance *inst = instance(*i);
+    if (!inst) {
+      return NULL;
+    }
+    if (!l.empty() && inst->grammar() != l.front()->grammar()) {
+      Log::instance()->error(inst->loc(),
+        "Fused instances have to use the same grammar.");
+      return NULL;
+    }
+    for (unsigned int k = 0; k < inst->product->width(); ++k) {
+      unsigned int n = k;
+      if (!seen.insert(inst->product->nth_algebra(n)).second) {
+        Log::instance()->error(inst->loc(),
+          "Fused instances have to use distinct algebras.");
+        return NULL;
+      }
+    }
+    l.push_back(inst);
+  }
+  if (l.size() < 2) {
+    Log::instance()->error("Fusing needs at least two instances.");
+    return NULL;
+  }
+
+  Product::Base *p = l.back()->product;
+  for (std::vector<Instance*>::reverse_iterator i = l.rbegin() + 1;
+       i != l.rend(); ++i) {
+    p = new Product::Cartesian((*i)->product, p, (*i)->loc());
+  }
+  Instance *r = new Instance(new std::string("_FUSED_"), p,
+                             l.front()->grammar());
+  instances["_FUSED_"] = r;
+  first_instance = r;
+  selected_grammar = r->grammar();
+  return r;
+}
+
+
 bool AST::insert_instance(std::string &n) {
   Instance *inst = instance(n);
   if (!inst) {
@@ -305,6 +356,14 @@ void AST::derive_roles() {
   for (hashtable<std::string, Algebra*>::iterator i = algebras.begin();
       i != algebras.end(); ++i) {
     i->second->derive_role();
+    for (hashtable<std::string, Fn_Def*>::iterator j =
+         i->second->choice_fns.begin(); j != i->second->choice_fns.end();
+         ++j) {
+      Expr::Fn_Call::Builtin t = j->second->choice_fn_type();
+      if (t == Expr::Fn_Call::KMINIMUM || t == Expr::Fn_Call::KMAXIMUM) {
+        top_k = Bool(true);
+      }
+    }
   }
 }
 
@@ -375,6 +434,14 @@ void AST::optimize_choice(Instance &inst) {
           f->add_simple_choice_fn_adaptor();
         }
       }
+    } else if (width == 1) {
+      // the list is kept as bounded heap of the k best candidates, the
+      // choice fn itself still sorts the (at most k) survivors
+      switch (choice_type) {
+      case Expr::Fn_Call::KMINIMUM : push = Type::List::KMIN; break;
+      case Expr::Fn_Call::KMAXIMUM : push = Type::List::KMAX; break;
+      default: {}
+      }
     }
     v.push_back(std::make_pair(push, i->first));
   }
@@ -392,6 +459,63 @@ void AST::optimize_choice(Instance &inst) {
 }
 
 
+// A ^ B of two numeric minimum/maximum algebras: the candidate lists are
+// kept as 2D Pareto fronts while pushing, i.e. dominated candidates are
+// rejected on insert instead of being filtered by the choice fn
+void AST::optimize_pareto_choice(Instance &inst) {
+  Product::Base *p = inst.product;
+  if (!p->is(Product::PARETO) || !p->left()->is(Product::SINGLE) ||
+      !p->right()->is(Product::SINGLE)) {
+    Log::instance()->warning(
+      "--pareto-stream needs a Pareto product of two single algebras.");
+    return;
+  }
+  if (float_acc) {
+    Log::instance()->warning(
+      "--pareto-stream is disabled for the float accuracy option.");
+    return;
+  }
+  Product::Two *two = dynamic_cast<Product::Two*>(p);
+  assert(two);
+
+  for (hashtable<std::string, Fn_Def*>::iterator i =
+       p->algebra()->choice_fns.begin();
+       i != p->algebra()->choice_fns.end(); ++i) {
+    Expr::Fn_Call::Builtin l = two->left_choice_fn_type(i->first);
+    Expr::Fn_Call::Builtin r = two->right_choice_fn_type(i->first);
+    if ((l != Expr::Fn_Call::MINIMUM && l != Expr::Fn_Call::MAXIMUM) ||
+        (r != Expr::Fn_Call::MINIMUM && r != Expr::Fn_Call::MAXIMUM)) {
+      continue;
+    }
+    if (!i->second->return_type->simple()->is(Type::LIST)) {
+      continue;
+    }
+    Type::Base *t = i->second->return_type->simple()->component()->simple();
+    bool numeric = t->is(Type::TUPLE);
+    for (int j = 0; numeric && j < 2; ++j) {
+      Type::Base *c = (j ? t->right() : t->left())->simple();
+      numeric = numeric && (c->is(Type::INT) || c->is(Type::SIZE) ||
+                            c->is(Type::FLOAT));
+    }
+    if (!numeric) {
+      continue;
+    }
+    Type::List::Push_Type push;
+    if (l == Expr::Fn_Call::MINIMUM) {
+      push = r == Expr::Fn_Call::MINIMUM ? Type::List::PARETO_MIN_MIN
+        : Type::List::PARETO_MIN_MAX;
+    } else {
+      push = r == Expr::Fn_Call::MINIMUM ? Type::List::PARETO_MAX_MIN
+        : Type::List::PARETO_MAX_MAX;
+    }
+    Opt_Choice_Visitor v(i->second, push);
+    grammar()->traverse(v);
+  }
+  FixLink fl;
+  grammar()->traverse(fl);
+}
+
+
 #include "classify_visitor.hh"
 #include "operator.hh"
 
@@ -416,7 +540,7 @@ void AST::optimize_classify(Instance &inst) {
     Opt_Choice_Visitor v(i->second, t, hdecl);
     grammar()->traverse(v);
 
-    Classify_Visitor w;
+    Classify_Visitor w(adaptive_hash);
     grammar()->traverse(w);
 
     if (inst.product->is(Product::SINGLE)) {
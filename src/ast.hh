@@ -187,6 +187,7 @@ class AST {
   void print_instances(std::ostream &s);
 
   Instance *instance(const std::string &n);
+  Instance *fuse_instances(const std::vector<std::string> &names);
   bool insert_instance(std::string &n);
   bool insert_instance(Instance *inst);
   bool instance_grammar_eliminate_lists(std::string &n);
@@ -209,6 +210,7 @@ class AST {
   void derive_roles();
 
   void optimize_choice(Instance &i);
+  void optimize_pareto_choice(Instance &i);
   void optimize_classify(Instance &i);
 
   // FIXME probably remove these get/setters
@@ -302,6 +304,42 @@ class AST {
 
   Bool kbest;
 
+  // alternatives over several sub-answer lists of a kminimum/kmaximum
+  // choice evaluate their candidates best first
+  Bool lazy_kbest;
+
+  // store fixed width tuple answers of tables as struct of arrays
+  Bool soa_tables;
+
+  // classified answer lists are Swiss tables instead of chained hash sets
+  Bool swiss_hash;
+
+  // shape_t is an id into the global table of interned shapes
+  Bool intern_shapes;
+
+  // short shape_t values are packed into one word
+  Bool small_shapes;
+
+  // short Rope values are stored inline
+  Bool small_ropes;
+
+  // classified answer lists are pre-sized from per NT size statistics
+  Bool adaptive_hash;
+
+  // --sample keeps the discrete distributions of the visited cells
+  Bool sample_cache;
+
+  // --sample splits the -r samples among the candidates of each cell
+  Bool sample_batch;
+
+  // some choice fn uses the kminimum/kmaximum builtins, i.e. the
+  // generated code has to set the size of the bounded top-k lists
+  Bool top_k;
+
+  // the Pareto product keeps an epsilon-approximate front (-P 6), i.e.
+  // the generated code reads epsilon from the command line
+  Bool pareto_eps;
+
   std::list<std::pair<Filter*, Expr::Fn_Call*> > sf_filter_code;
 
   Product::Base * get_backtrack_product() const {
@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <list>
+#include <vector>
 
 #include "classify_visitor.hh"
 
@@ -31,9 +32,52 @@
 #include "statement.hh"
 #include "statement/fn_call.hh"
 #include "fn_def.hh"
+#include "expr.hh"
 
 
 
+// Identifies the table cell of the answer list for Hash::Size_Stats: the
+// non-terminal and the length of its subword, summed over all tracks.
+void Classify_Visitor::add_cell_args(Symbol::NT &n, Statement::Fn_Call *f) {
+  f->add_arg(new Expr::Const(static_cast<int>(n.grammar_index())));
+  Expr::Base *len = NULL;
+  std::vector<Expr::Base*>::iterator j = n.right_indices.begin();
+  for (std::vector<Expr::Base*>::iterator i = n.left_indices.begin();
+       i != n.left_indices.end(); ++i, ++j) {
+    Expr::Base *l = (*j)->minus(*i);
+    len = len ? new Expr::Plus(len, l) : l;
+  }
+  f->add_arg(len ? len : new Expr::Const(0));
+}
+
+// hash_hint(answers, ...) directly after the empty(answers) which follows
+// the declaration, i.e. before the first element is pushed
+void Classify_Visitor::add_hint(Symbol::NT &n, Fn_Def *fn) {
+  std::list<Statement::Base*> &l = fn->stmts;
+  for (std::list<Statement::Base*>::iterator i = l.begin(); i != l.end();
+       ++i) {
+    if (*i != &n.return_decl())
+      continue;
+    ++i;
+    for (std::list<Statement::Base*>::iterator j = i; j != l.end(); ++j) {
+      if (!(*j)->is(Statement::FN_CALL))
+        continue;
+      Statement::Fn_Call *e = dynamic_cast<Statement::Fn_Call*>(*j);
+      if (e->builtin == Statement::Fn_Call::EMPTY && !e->args.empty() &&
+          e->args.front()->var_decl() == &n.return_decl()) {
+        i = ++j;
+        break;
+      }
+    }
+    Statement::Fn_Call *hint = new Statement::Fn_Call(
+        Statement::Fn_Call::HASH_HINT);
+    hint->add_arg(new Expr::Vacc(n.return_decl()));
+    add_cell_args(n, hint);
+    l.insert(i, hint);
+    return;
+  }
+}
+
 void Classify_Visitor::visit(Symbol::NT &n) {
   if (!n.eval_decl) {
     if (!n.return_decl().type->simple()->is(Type::LIST))
@@ -67,6 +111,7 @@ void Classify_Visitor::visit(Symbol::NT &n) {
   for (std::list<Fn_Def*>::iterator a = list.begin(); a != list.end(); ++a) {
     // Fn_Def *fn = dynamic_cast<Fn_Def*>(n.code());
     Fn_Def *fn = *a;
+    bool filtered = false;
 
     for (Statement::iterator i = Statement::begin(*fn); i != Statement::end();
         ++i) {
@@ -80,7 +125,11 @@ void Classify_Visitor::visit(Symbol::NT &n) {
           Statement::Fn_Call *filter = new Statement::Fn_Call(
               Statement::Fn_Call::HASH_FILTER);
           filter->add_arg(new Expr::Vacc(n.return_decl()));
+          if (adaptive) {
+            add_cell_args(n, filter);
+          }
           *i = filter;
+          filtered = true;
 
           ++i;
           // (*i)->disable();
@@ -104,5 +153,8 @@ void Classify_Visitor::visit(Symbol::NT &n) {
         }
       }
     }
+    if (adaptive && filtered) {
+      add_hint(n, fn);
+    }
   }
 }
@@ -30,11 +30,21 @@
 #include "type.hh"
 
 class Fn_Def;
+namespace Statement { class Fn_Call; }
 
 #include "symbol_fwd.hh"
 
 class Classify_Visitor : public Visitor {
+ private:
+    // pre-size the hashed answer lists from runtime statistics
+    bool adaptive;
+
+    void add_cell_args(Symbol::NT &n, Statement::Fn_Call *f);
+    void add_hint(Symbol::NT &n, Fn_Def *fn);
+
  public:
+    explicit Classify_Visitor(bool a = false) : adaptive(a) {}
+
     void visit(Symbol::NT &n);
 };
 
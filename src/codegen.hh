@@ -48,6 +48,7 @@ class Mode {
 
   Bool subopt_buddy_;
   Bool marker_;
+  Bool subopt_stream_;
 
   Bool sample_;
 
@@ -101,6 +102,9 @@ class Mode {
   bool marker() const { return marker_; }
   void set_marker() { marker_ = Bool(true); }
 
+  bool subopt_stream() const { return subopt_stream_; }
+  void set_subopt_stream() { subopt_stream_ = Bool(true); }
+
   bool sample() const { return sample_; }
   void set_sample(bool b) { sample_ = Bool(b); }
 };
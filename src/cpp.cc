@@ -212,7 +212,57 @@ void Printer::Cpp::print(const Statement::Sorter &stmt) {
     stream << ", " << *stmt.op << ");" << endl;
 }
 
+// --lazy-kbest: the nested loops over the sub-answer lists of an
+// alternative as best first enumeration, see Alt::Simple::lazy_kbest()
+void Printer::Cpp::print_frontier(const Statement::Foreach &stmt) {
+  std::list<const Statement::Foreach*> loops;
+  const Statement::Foreach *f = &stmt;
+  for (;;) {
+    loops.push_back(f);
+    if (f->statements.size() != 1 ||
+        !f->statements.front()->is(Statement::FOREACH)) {
+      break;
+    }
+    f = dynamic_cast<const Statement::Foreach*>(f->statements.front());
+  }
+  Type::List *l = dynamic_cast<Type::List*>(
+    stmt.frontier_answers->type->simple());
+  assert(l);
+  const std::string &fr = *stmt.frontier->name;
+  stream << indent() << "Top_K_Frontier " << fr << '('
+    << *stmt.frontier_answers->name << ", "
+    << (l->push_type() == Type::List::KMAX ? "std::greater<>()"
+                                           : "std::less<>()")
+    << ", " << loops.size() << ");" << endl;
+  size_t d = 0;
+  for (std::list<const Statement::Foreach*>::iterator i = loops.begin();
+       i != loops.end(); ++i, ++d) {
+    stream << indent() << fr << ".dim(" << d << ", "
+      << *(*i)->container->name << ");" << endl;
+  }
+  stream << indent() << "while (" << fr << ".next()) {" << endl;
+  inc_indent();
+  d = 0;
+  for (std::list<const Statement::Foreach*>::iterator i = loops.begin();
+       i != loops.end(); ++i, ++d) {
+    stream << indent() << *(*i)->elem->type << ' ' << *(*i)->elem->name
+      << " = " << fr << ".at(" << d << ", " << *(*i)->container->name
+      << ");" << endl;
+  }
+  for (std::list<Statement::Base*>::const_iterator i =
+       loops.back()->statements.begin();
+       i != loops.back()->statements.end(); ++i) {
+    stream << **i << endl;
+  }
+  dec_indent();
+  stream << indent() << '}';
+}
+
 void Printer::Cpp::print(const Statement::Foreach &stmt) {
+  if (stmt.frontier) {
+    print_frontier(stmt);
+    return;
+  }
   std::string itr(*stmt.elem->name + "_itr");
 
   bool started_loop = true;
@@ -471,7 +521,8 @@ void Printer::Cpp::print(const Statement::Fn_Call &stmt) {
   std::list<Expr::Base*>::const_iterator i = stmt.args.begin();
   if (stmt.is_obj == false) {
     if (stmt.builtin == Statement::Fn_Call::PUSH_BACK ||
-        stmt.builtin == Statement::Fn_Call::APPEND) {
+        stmt.builtin == Statement::Fn_Call::APPEND ||
+        stmt.builtin == Statement::Fn_Call::FINALIZE) {
       // assert(stmt.args.size() == 2);
       Statement::Var_Decl *v = stmt.args.front()->var_decl();
       if (v && v->type->is(::Type::LIST)) {
@@ -479,7 +530,9 @@ void Printer::Cpp::print(const Statement::Fn_Call &stmt) {
         assert(l);
         stream << indent() << stmt.name();
         if (l->push_type() != Type::List::NORMAL &&
-            l->push_type() != Type::List::HASH) {
+            l->push_type() != Type::List::HASH &&
+            (stmt.builtin != Statement::Fn_Call::FINALIZE ||
+             l->push_type() >= Type::List::PARETO_MIN_MIN)) {
           stream << "_";
           stream << l->push_str();
         }
@@ -626,6 +679,11 @@ void Printer::Cpp::print(const Fn_Def &fn_def) {
   if (fn_def.adaptor)
     stream << *fn_def.adaptor;
 
+  if (fn_def.lazy_left)
+    stream << *fn_def.lazy_left;
+  if (fn_def.lazy_right)
+    stream << *fn_def.lazy_right;
+
   if (fn_def.comparator) {
             stream << *fn_def.comparator;
         }
@@ -722,6 +780,23 @@ void Printer::Cpp::print(const Operator &op) {
     }
 
     stream << indent() << "   }" << endl;
+
+    if (!op.key_stmts.empty()) {
+      // keys(e1, e1, k), the second parameter is needed by the shared
+      // dimension extraction only
+      std::list<Para_Decl::Base*>::const_iterator p = op.paras.begin();
+      stream << indent() << "void keys(";
+      print(*p);
+      stream << ", ";
+      print(*++p);
+      stream << ", double *k) {" << endl;
+      for (std::list<Statement::Base*>::const_iterator i =
+           op.key_stmts.begin(); i != op.key_stmts.end(); ++i) {
+        stream << indent() << "    " << **i << endl;
+      }
+      stream << indent() << "   }" << endl;
+    }
+
     stream << indent() << "} " <<  *op.object << " ;" << endl;
 }
 
@@ -1100,7 +1175,11 @@ void Printer::Cpp::print(const Statement::Table_Decl &t) {
 
   print_most_decl(t.nt());
 
-  stream << indent() << "std::vector<" << dtype << "> array;" << endl;
+  if (t.soa()) {
+    stream << indent() << "Table::Soa<" << dtype << "> array;" << endl;
+  } else {
+    stream << indent() << "std::vector<" << dtype << "> array;" << endl;
+  }
   if  (!cyk) {
     stream << indent() << "std::vector<bool> tabulated;" << endl;
   }
@@ -1204,10 +1283,14 @@ void Printer::Cpp::print(const Statement::Table_Decl &t) {
 
   if (!cyk) {
     stream << t.fn_is_tab() << endl;
-    // needed by subopt classify
+    // needed by subopt classify: the tables of the first phase are
+    // released before the second phase fills its own
     stream << indent() << "void clear() {" << endl;
     inc_indent();
     stream << indent() << "tabulated.clear();" << endl;
+    stream << indent() << "tabulated.shrink_to_fit();" << endl;
+    stream << indent() << "array.clear();" << endl;
+    stream << indent() << "array.shrink_to_fit();" << endl;
     dec_indent();
     stream << indent() << "}" << endl << endl;
   }
@@ -1242,6 +1325,15 @@ void Printer::Cpp::print(const Type::Shape &t) {
 }
 
 
+void Printer::Cpp::print(const Type::DotBracket &t) {
+  if (in_fn_head) {
+    stream << "const DotBracket &";
+  } else {
+    stream << "DotBracket";
+  }
+}
+
+
 void Printer::Cpp::print(const Type::Referencable &t) {
   stream << *t.base << " & ";
 }
@@ -1854,6 +1946,12 @@ void Printer::Cpp::print_init_fn(const AST &ast) {
       stream << (*i)->ext_name() << "::set_k(opts.k);\n";
     }
   }
+  if (ast.top_k) {
+    stream << indent() << "Top_K::set(opts.k);" << endl;
+  }
+  if (ast.pareto_eps) {
+    stream << indent() << "Pareto_Eps::set(opts.pareto_eps);" << endl;
+  }
 
   dec_indent();
   stream << indent() << '}' << endl << endl;
@@ -1940,12 +2038,36 @@ void Printer::Cpp::header(const AST &ast) {
     if (ast.code_mode().sample()) {
       stream << "#define USE_GSL\n";
     }
+    if (ast.sample_cache) {
+      stream << "#define SAMPLE_CACHE\n";
+    }
+    if (ast.sample_batch) {
+      stream << "#define SAMPLE_BATCH\n";
+    }
     if (ast.get_float_acc() > 0) {
             stream << "#define FLOAT_ACC " << ast.get_float_acc() << "\n";
     }
     if (ast.outside_generation()) {
       stream << "#define OUTSIDE\n";
     }
+    if (ast.pareto_eps) {
+      stream << "#define PARETO_EPS\n";
+    }
+    if (ast.swiss_hash) {
+      stream << "#define HASH_SWISS\n";
+    }
+    if (ast.intern_shapes) {
+      stream << "#define SHAPE_INTERN\n";
+    }
+    if (ast.small_shapes) {
+      stream << "#define SHAPE_SMALL\n";
+    }
+    if (ast.small_ropes) {
+      stream << "#define ROPE_SMALL\n";
+    }
+    if (ast.adaptive_hash) {
+      stream << "#define HASH_ADAPTIVE\n";
+    }
     if (ast.uses_tikz()) {
       stream << "#define TIKZ\n";
     }
@@ -2466,10 +2588,17 @@ void Printer::Cpp::print_subopt_fn(const AST &ast) {
   print_axiom_args(ast);
   stream << ");" << endl;
 
-  if (!ast.code_mode().marker()) {
-    stream << indent() << *f->return_type << " l = ";
+  bool streamed = ast.code_mode().subopt_stream();
+  if (streamed) {
+    // just the slot of the axiom
+    stream << indent() << *f->return_type->deref() << " l = bt_" << *f->name
+           << "(";
+  } else {
+    if (!ast.code_mode().marker()) {
+      stream << indent() << *f->return_type << " l = ";
+    }
+    stream << f->target_name() << "(";
   }
-  stream << f->target_name() << "(";
   bool b = print_axiom_args(ast);
   if (b) {
     stream << ", ";
@@ -2480,14 +2609,20 @@ void Printer::Cpp::print_subopt_fn(const AST &ast) {
     if (ast.uses_tikz()) {
       stream << indent() << "int rank = 1;" << endl;
     }
-    stream << indent() << "for (" << *f->return_type->deref()
-           << "::iterator i = l.ref().begin(); "
-           << "i != l.ref().end(); ++i) {" << endl;
-    inc_indent();
+    if (streamed) {
+      stream << indent() << "subopt_stream(l, global_score, delta, [&]("
+             << *score_type << " v, " << *bt_type << " bt) {" << endl;
+      inc_indent();
+    } else {
+      stream << indent() << "for (" << *f->return_type->deref()
+             << "::iterator i = l.ref().begin(); "
+             << "i != l.ref().end(); ++i) {" << endl;
+      inc_indent();
 
-    stream << indent() << *bt_type << " bt = (*i).second;" << endl;
+      stream << indent() << *bt_type << " bt = (*i).second;" << endl;
 
-    stream << indent() << *score_type << " v = (*i).first;" << endl;
+      stream << indent() << *score_type << " v = (*i).first;" << endl;
+    }
 
     stream << indent() << "intrusive_ptr<Eval_List<" << *pp_type
            << "> > elist = bt->eval();" << endl;
@@ -2506,7 +2641,11 @@ void Printer::Cpp::print_subopt_fn(const AST &ast) {
     }
 
     dec_indent();
-    stream << indent() << "}" << endl;
+    if (streamed) {
+      stream << indent() << "});" << endl;
+    } else {
+      stream << indent() << "}" << endl;
+    }
   }
 
   print_marker_clear(ast);
@@ -2890,7 +3029,10 @@ void Printer::Cpp::imports(const AST &ast) {
   stream << endl;
   stream << "#include \"rtlib/generic_opts.hh\"\n";
   stream << "#include \"rtlib/pareto_dom_sort.hh\"\n";
-  stream << "#include \"rtlib/pareto_yukish_ref.hh\"\n\n";
+  stream << "#include \"rtlib/pareto_yukish_ref.hh\"\n";
+  stream << "#include \"rtlib/pareto_parallel.hh\"\n";
+  stream << "#include \"rtlib/pareto_eps.hh\"\n";
+  stream << "#include \"rtlib/pareto_auto.hh\"\n\n";
 }
 
 
@@ -2989,12 +3131,30 @@ void Printer::Cpp::print(const Statement::Backtrace_Decl &d) {
   dec_indent();
   stream << indent() << "}" << endl << endl;
 
+  if (ast->code_mode().subopt_stream()) {
+    stream << indent() << "void subtrees(std::vector<intrusive_ptr<"
+           << "Backtrace<Value, pos_int> > *> &l) {" << endl;
+    inc_indent();
+    for (std::list<Statement::Var_Decl*>::const_iterator i = paras.begin();
+         i != paras.end(); ++i) {
+      if ((*i)->type->is(Type::BACKTRACE)) {
+        stream << indent() << "l.push_back(&" << *(*i)->name << ");" << endl;
+      }
+    }
+    dec_indent();
+    stream << indent() << "}" << endl << endl;
+  }
+
   const std::list<Fn_Def*> &l = d.algebra_code_deps();
   for (std::list<Fn_Def*>::const_iterator i = l.begin(); i != l.end(); ++i) {
     stream << **i << endl;
   }
   stream << d.algebra_code() << endl;
-  stream << d.eval_code();
+  if (ast->sample_batch) {
+    print_batch_eval(d);
+  } else {
+    stream << d.eval_code();
+  }
   dec_indent();
   stream << indent() << "};" << endl << endl;
   in_class = false;
@@ -3004,6 +3164,10 @@ void Printer::Cpp::print(const Statement::Backtrace_Decl &d) {
 void Printer::Cpp::print(const Statement::Backtrace_NT_Decl &d) {
   const std::list<std::string> &l = d.track_args();
   const std::list<Para_Decl::Base*> &p = d.ntparas();
+  if (ast->code_mode().subopt_stream()) {
+    print_subopt_slot(d);
+    return;
+  }
   if (d.score_type()) {
     std::string name;
     name = "Backtrace_nt_" + d.name() + "_Back";
@@ -3177,7 +3341,16 @@ void Printer::Cpp::print(const Statement::Backtrace_NT_Decl &d) {
   stream << indent()
     << "intrusive_ptr<Backtrace<Value, pos_int> > backtrack() {" << endl;
   inc_indent();
-  stream << indent() << "return klass->bt_nt_" << d.name() << "(";
+  if (ast->sample_batch) {
+    // the cell is sampled for the samples of this node
+    stream << indent() << "std::vector<unsigned> old = scil::batch();"
+           << endl;
+    stream << indent() << "scil::batch() = this->batch;" << endl;
+    stream << indent() << "intrusive_ptr<Backtrace<Value, pos_int> > r = ";
+  } else {
+    stream << indent() << "return ";
+  }
+  stream << "klass->bt_nt_" << d.name() << "(";
 
   std::list<std::string>::const_iterator i = l.begin();
   if (i != l.end()) {
@@ -3195,13 +3368,22 @@ void Printer::Cpp::print(const Statement::Backtrace_NT_Decl &d) {
   }
 
   stream << ");" << endl;
+  if (ast->sample_batch) {
+    stream << indent() << "scil::batch() = old;" << endl;
+    stream << indent() << "return r;" << endl;
+  }
   dec_indent();
   stream << indent() << '}' << endl << endl;
   // stream << "Eval_List<Value>* eval() { assert(false); }" << endl;
   stream << indent() << "intrusive_ptr<Eval_List<Value> > eval() {" << endl;
   inc_indent();
   stream << indent() << "proxy = backtrack();" << endl;
-  stream << indent() << "return proxy->eval();" << endl;
+  if (ast->sample_batch) {
+    stream << indent() << "return evaluate_batch(proxy, this->batch);"
+           << endl;
+  } else {
+    stream << indent() << "return proxy->eval();" << endl;
+  }
   dec_indent();
   stream << indent() << "}" << endl;
   dec_indent();
@@ -3210,6 +3392,179 @@ void Printer::Cpp::print(const Statement::Backtrace_NT_Decl &d) {
 }
 
 
+// --sample-batch: the node stands for the samples this->batch. Each
+// Backtrace argument is evaluated for these samples, in sample order, and
+// the values of each sample are combined as in eval_code(), i.e. the cross
+// product of the argument values of that sample.
+void Printer::Cpp::print_batch_eval(const Statement::Backtrace_Decl &d) {
+  const Fn_Def &fn = d.algebra_code();
+  const std::list<Statement::Var_Decl*> &paras = d.paras();
+  std::list<Statement::Var_Decl*> bts;
+  for (std::list<Statement::Var_Decl*>::const_iterator i = paras.begin();
+       i != paras.end(); ++i) {
+    if ((*i)->type->is(Type::BACKTRACE)) {
+      bts.push_back(*i);
+    }
+  }
+
+  stream << indent() << "intrusive_ptr<Eval_List<Value> > eval() {" << endl;
+  inc_indent();
+  stream << indent() << "intrusive_ptr<Eval_List<Value> > answer = "
+         << "new Eval_List<Value>();" << endl;
+  for (std::list<Statement::Var_Decl*>::iterator i = bts.begin();
+       i != bts.end(); ++i) {
+    const std::string &n = *(*i)->name;
+    stream << indent() << "intrusive_ptr<Eval_List<Value> > " << n
+           << "_elist = evaluate_batch(" << n << ", this->batch);" << endl;
+    stream << indent() << "size_t " << n << "_pos = 0;" << endl;
+  }
+  stream << indent() << "for (std::vector<unsigned>::iterator id = "
+         << "this->batch.begin(); id != this->batch.end(); ++id) {" << endl;
+  inc_indent();
+  for (std::list<Statement::Var_Decl*>::iterator i = bts.begin();
+       i != bts.end(); ++i) {
+    const std::string &n = *(*i)->name;
+    stream << indent() << "size_t " << n << "_end = " << n
+           << "_elist->batch_end(" << n << "_pos, *id);" << endl;
+  }
+  for (std::list<Statement::Var_Decl*>::iterator i = bts.begin();
+       i != bts.end(); ++i) {
+    const std::string &n = *(*i)->name;
+    stream << indent() << "for (size_t " << n << "_i = " << n << "_pos; "
+           << n << "_i < " << n << "_end; ++" << n << "_i) {" << endl;
+    inc_indent();
+  }
+  stream << indent() << *fn.return_type << " ret = " << *fn.name << '(';
+  bool first = true;
+  for (std::list<Statement::Var_Decl*>::const_iterator i = paras.begin();
+       i != paras.end(); ++i) {
+    if (!first) {
+      stream << ", ";
+    }
+    first = false;
+    const std::string &n = *(*i)->name;
+    if ((*i)->type->is(Type::BACKTRACE)) {
+      stream << "*(" << n << "_elist->begin() + " << n << "_i)";
+    } else {
+      stream << n;
+    }
+  }
+  for (std::list<Para_Decl::Base*>::const_iterator i = fn.ntparas().begin();
+       i != fn.ntparas().end(); ++i) {
+    Para_Decl::Simple *s = dynamic_cast<Para_Decl::Simple*>(*i);
+    assert(s);
+    if (!first) {
+      stream << ", ";
+    }
+    first = false;
+    stream << *s->name();
+  }
+  stream << ");" << endl;
+  stream << indent() << "answer->push_back(*id, ret);" << endl;
+  for (std::list<Statement::Var_Decl*>::iterator i = bts.begin();
+       i != bts.end(); ++i) {
+    dec_indent();
+    stream << indent() << '}' << endl;
+  }
+  for (std::list<Statement::Var_Decl*>::iterator i = bts.begin();
+       i != bts.end(); ++i) {
+    const std::string &n = *(*i)->name;
+    stream << indent() << n << "_pos = " << n << "_end;" << endl;
+  }
+  dec_indent();
+  stream << indent() << '}' << endl;
+  for (std::list<Statement::Var_Decl*>::iterator i = bts.begin();
+       i != bts.end(); ++i) {
+    stream << indent() << "erase(" << *(*i)->name << "_elist);" << endl;
+  }
+  stream << indent() << "return answer;" << endl;
+  dec_indent();
+  stream << indent() << '}' << endl;
+}
+
+
+// the --subopt-stream slot of a sub-problem, see rtlib/subopt.hh
+void Printer::Cpp::print_subopt_slot(const Statement::Backtrace_NT_Decl &d) {
+  const std::list<std::string> &l = d.track_args();
+  const std::list<Para_Decl::Base*> &p = d.ntparas();
+  assert(d.score_type());
+  ::Type::Base *single = d.score_type();
+  if (single->is(Type::LIST)) {
+    single = single->component();
+  }
+  std::ostringstream o;
+  o << "Backtrace_Slot<" << *single << ", Value, pos_int>";
+  std::string base(o.str());
+  std::string name = "Backtrace_nt_" + d.name();
+
+  stream << indent() << "template <typename Klass, typename Value, "
+         << "typename pos_int>" << endl;
+  stream << indent() << "struct " << name << " : public " << base << " {"
+         << endl;
+  inc_indent();
+  stream << indent() << "Klass *klass;" << endl;
+  for (std::list<std::string>::const_iterator i = l.begin();
+       i != l.end(); ++i) {
+    stream << indent() << "pos_int " << *i << ";" << endl;
+  }
+  for (std::list<Para_Decl::Base*>::const_iterator i = p.begin();
+       i != p.end(); ++i) {
+    Para_Decl::Simple *s = dynamic_cast<Para_Decl::Simple*>(*i);
+    assert(s);
+    stream << indent() << *s->type() << ' ' << *s->name() << ";" << endl;
+  }
+  stream << endl;
+
+  stream << indent() << name << "(Klass *klass_";
+  for (std::list<std::string>::const_iterator i = l.begin();
+       i != l.end(); ++i) {
+    stream << ", pos_int " << *i << "_";
+  }
+  for (std::list<Para_Decl::Base*>::const_iterator i = p.begin();
+       i != p.end(); ++i) {
+    Para_Decl::Simple *s = dynamic_cast<Para_Decl::Simple*>(*i);
+    assert(s);
+    stream << ", " << *s->type() << ' ' << *s->name() << '_';
+  }
+  stream << ", const " << *single << " &score_)" << endl;
+  stream << indent() << "  : " << base << "(score_), klass(klass_)";
+  for (std::list<std::string>::const_iterator i = l.begin();
+       i != l.end(); ++i) {
+    stream << ", " << *i << "(" << *i << "_)";
+  }
+  for (std::list<Para_Decl::Base*>::const_iterator i = p.begin();
+       i != p.end(); ++i) {
+    Para_Decl::Simple *s = dynamic_cast<Para_Decl::Simple*>(*i);
+    assert(s);
+    stream << ", " << *s->name() << '(' << *s->name() << "_)";
+  }
+  stream << " {" << endl;
+  stream << indent() << "}" << endl << endl;
+
+  stream << indent() << "void expand(std::vector<typename " << base
+         << "::alt_t> &alts, const " << *single << " &global_score, const "
+         << *single << " &delta) {" << endl;
+  inc_indent();
+  stream << indent() << "slot_alternatives(alts, klass->bt_expand_nt_"
+         << d.name() << "(";
+  for (std::list<std::string>::const_iterator i = l.begin();
+       i != l.end(); ++i) {
+    stream << *i << ", ";
+  }
+  for (std::list<Para_Decl::Base*>::const_iterator i = p.begin();
+       i != p.end(); ++i) {
+    Para_Decl::Simple *s = dynamic_cast<Para_Decl::Simple*>(*i);
+    assert(s);
+    stream << *s->name() << ", ";
+  }
+  stream << "global_score, delta));" << endl;
+  dec_indent();
+  stream << indent() << "}" << endl;
+  dec_indent();
+  stream << indent() << "};" << endl << endl;
+}
+
+
 void Printer::Cpp::print(const Statement::Hash_Decl &d) {
   stream << "class " << d.ext_name() << " {" << endl;
   stream << " public:" << endl;
@@ -109,6 +109,10 @@ class Cpp : public Base {
     void print_marker_init(const AST &ast);
     void print_marker_clear(const AST &ast);
 
+    void print_subopt_slot(const Statement::Backtrace_NT_Decl &d);
+    void print_batch_eval(const Statement::Backtrace_Decl &d);
+    void print_frontier(const Statement::Foreach &stmt);
+
  public:
     /* generate code to print statements after reporing the result list,
      * useful e.g. to include statements for LaTeX documents when generating
@@ -187,6 +191,7 @@ class Cpp : public Base {
 
     void print(const Type::Subseq &expr);
     void print(const Type::Shape &expr);
+    void print(const Type::DotBracket &expr);
     void print(const Type::Referencable &expr);
     void print(const Type::Rational &expr);
     void print(const Type::BigInt &expr);
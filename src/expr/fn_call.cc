@@ -66,6 +66,7 @@ Expr::Fn_Call::Fn_Call(const Filter &f)
 #include "../var_acc.hh"
 #include "../statement.hh"
 #include "../type/multi.hh"
+#include "../type.hh"
 
 void Expr::Fn_Call::put_arg(std::ostream &s, Expr::Base *e) const {
   if (!e) {
@@ -113,6 +114,19 @@ void Expr::Fn_Call::put(std::ostream &s) const {
     s << *name;
   else
     s << map_builtin_to_string[builtin];
+  if (builtin == SURVIVES) {
+    // like push_back, dispatched on the optimized choice of the answer list
+    assert(i != exprs.end());
+    Statement::Var_Decl *v = (*i)->var_decl();
+    if (v && v->type->is(::Type::LIST)) {
+      ::Type::List *l = dynamic_cast< ::Type::List*>(v->type);
+      assert(l);
+      if (l->push_type() == ::Type::List::MIN_OTHER ||
+          l->push_type() == ::Type::List::MAX_OTHER) {
+        s << '_' << l->push_str();
+      }
+    }
+  }
   if (type_param)
     s << '<' << *type_param << '>';
 
@@ -162,6 +176,9 @@ const char * Expr::Fn_Call::map_builtin_to_string[] = {
   "exp2sum",
   "bitsum",
   "pow",
+  "kminimum",
+  "kmaximum",
+  "survives",
   0
 };
 
@@ -77,7 +77,10 @@ class Fn_Call : public Base {
       LOG2,
       EXP2SUM,
       BITSUM,
-      POW
+      POW,
+      KMINIMUM,
+      KMAXIMUM,
+      SURVIVES
     };
 
 
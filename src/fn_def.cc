@@ -48,8 +48,8 @@
 
 // join two Function definitions into one
 Fn_Def::Fn_Def(Fn_Def &a, Fn_Def &b)
-  :  adaptor(NULL), comparator(NULL), sorter(NULL),
-    choice_fn_type_(Expr::Fn_Call::NONE) {
+  :  adaptor(NULL), comparator(NULL), sorter(NULL), lazy_left(NULL),
+    lazy_right(NULL), choice_fn_type_(Expr::Fn_Call::NONE) {
   gen_type = a.gen_type;
   comperator_suffix = b.comperator_suffix;
   sorter_suffix = b.sorter_suffix;
@@ -173,6 +173,8 @@ Fn_Def::Fn_Def(const Fn_Decl &other)
   adaptor = NULL;
   comparator = NULL;
   sorter = NULL;
+  lazy_left = NULL;
+  lazy_right = NULL;
   nullary_sort_ob = NULL;
 
   gen_type = STANDARD;
@@ -431,6 +433,37 @@ void Fn_Def::codegen(Fn_Def &a, Fn_Def &b, Product::Two &product) {
   left_fn->add(a.ntparas_);
   right_fn->add(a.ntparas_);
 
+  if (product.lazy()) {
+    lazy_left = new Fn_Def(a.return_type, name);
+    lazy_left->set_target_name(target_name() + "_left");
+    lazy_left->paras = paras;
+    lazy_left->ntparas_ = ntparas_;
+    lazy_left->stmts.insert(lazy_left->stmts.end(), v_list.begin(),
+                            v_list.end());
+    lazy_left->stmts.push_back(new Statement::Return(left_fn));
+
+    // the full candidate from an already evaluated left component
+    Statement::Var_Decl *ans_left = new Statement::Var_Decl(
+      a.return_type, new std::string("ans_left"));
+    lazy_right = new Fn_Def(return_type, name);
+    lazy_right->set_target_name(target_name() + "_right");
+    lazy_right->paras.push_back(
+      new Para_Decl::Simple(a.return_type, ans_left->name));
+    lazy_right->paras.insert(lazy_right->paras.end(), paras.begin(),
+                             paras.end());
+    lazy_right->ntparas_ = ntparas_;
+    lazy_right->stmts.insert(lazy_right->stmts.end(), w_list.begin(),
+                             w_list.end());
+    Statement::Var_Decl *lazy_ret = new Statement::Var_Decl(return_type,
+        new std::string("ret"));
+    lazy_right->stmts.push_back(lazy_ret);
+    lazy_right->stmts.push_back(
+      new Statement::Var_Assign(lazy_ret->left(), *ans_left));
+    lazy_right->stmts.push_back(
+      new Statement::Var_Assign(lazy_ret->right(), right_fn));
+    lazy_right->stmts.push_back(new Statement::Return(*lazy_ret));
+  }
+
   Statement::Var_Decl *ret_left =
     new Statement::Var_Decl(a.return_type,
         new std::string("ret_left"), left_fn);
@@ -710,7 +743,28 @@ void Fn_Def::codegen_choice(Fn_Def &a, Fn_Def &b, Product::Two &product) {
               break;
           case Product::Pareto::NoSortDomOpt:
               codegen_compare(product);
-              codegen_pareto_domination_nosort(a, b, product);
+              codegen_pareto_domination_nosort(a, b, product,
+                Statement::Fn_Call::PARETO_DOMINATION_SORT);
+              break;
+          case Product::Pareto::ParallelDomOpt:
+              codegen_compare(product);
+              codegen_pareto_domination_nosort(a, b, product,
+                Statement::Fn_Call::PARETO_PARALLEL);
+              break;
+          case Product::Pareto::EpsDomOpt:
+              codegen_compare(product);
+              if (comparator->key_stmts.empty()) {
+                Log::instance()->warning(location,
+                  "Not all Pareto dimensions are numeric minimum/maximum "
+                  "choices, thus -P 6 computes the exact front.");
+              }
+              codegen_pareto_domination_nosort(a, b, product,
+                Statement::Fn_Call::PARETO_EPS);
+              break;
+          case Product::Pareto::AutoDomOpt:
+              codegen_compare(product);
+              codegen_pareto_domination_nosort(a, b, product,
+                Statement::Fn_Call::PARETO_AUTO);
               break;
           case Product::Pareto::MultiDimOpt:
               int dim = codegen_compare(product);
@@ -1014,6 +1068,27 @@ void Fn_Def::codegen_times(Fn_Def &a, Fn_Def &b, Product::Two &product) {
   Statement::Var_Decl *elem = new Statement::Var_Decl(
       return_type->left(), "elem");
 
+  // the k classes of kminimum/kmaximum are ordered, thus all candidates
+  // are joined with their classes in one pass, see rtlib/top_k.hh
+  Expr::Fn_Call::Builtin left_fn = a.choice_fn_type();
+  if (!(product.left_mode(*name).number == Mode::ONE) &&
+      b.choice_mode() == Mode::PRETTY && product.type() == Product::TIMES &&
+      (left_fn == Expr::Fn_Call::KMINIMUM ||
+       left_fn == Expr::Fn_Call::KMAXIMUM)) {
+    Statement::Var_Decl *input_list = new Statement::Var_Decl(
+        types.front(), names.front(), new Expr::Vacc(names.front()));
+    Statement::Fn_Call *join =
+      new Statement::Fn_Call(Statement::Fn_Call::JOIN_CLASSES);
+    join->add_arg(*answers);
+    join->add_arg(*input_list);
+    join->add_arg(*left_answers);
+    join->add_arg(new Expr::Const(
+      new Const::Bool(product.no_coopt_class())));
+    stmts.push_back(join);
+    stmts.push_back(new Statement::Return(*answers));
+    return;
+  }
+
   std::list<Statement::Base*> *loop_body = &stmts;
   if (product.left_mode(*name).number == Mode::ONE) {
     stmts.push_back(elem);
@@ -2478,6 +2553,11 @@ int Fn_Def::codegen_pareto_comparator_all_dim(
 
   comp.stmts.push_back(sw);
 
+  // numeric minimum/maximum dimensions are additionally exported as keys
+  // (smaller is better) for the packed dominance checks of the rtlib
+  bool packable = true;
+  std::list<Statement::Base*> keys;
+
   for (; it != c_1_products.end(); ++it, ++it_c1, ++it_c2, ++d) {
         std::ostringstream D_str;
         D_str << d;
@@ -2498,6 +2578,23 @@ int Fn_Def::codegen_pareto_comparator_all_dim(
            type = x->type;
         }
 
+        Expr::Fn_Call::Builtin choice = left ? prod.left_choice_fn_type(*name)
+          : prod.right_choice_fn_type(*name);
+        Type::Base *t = type->simple();
+        if ((choice == Expr::Fn_Call::MINIMUM ||
+             choice == Expr::Fn_Call::MAXIMUM) &&
+            (t->is(Type::INT) || t->is(Type::SIZE) || t->is(Type::FLOAT))) {
+          Var_Acc::Array *k = new Var_Acc::Array(
+            new Var_Acc::Plain(new std::string("k")), new Expr::Const(d - 1));
+          keys.push_back(new Statement::Var_Assign(k, new Expr::Vacc(*u)));
+          if (choice == Expr::Fn_Call::MAXIMUM) {
+            keys.push_back(new Statement::Var_Assign(k, new Expr::Minus(
+              new Expr::Const(0), new Expr::Vacc(k))));
+          }
+        } else {
+          packable = false;
+        }
+
         // apply choice function
         Statement::Var_Decl *answer = new Statement::Var_Decl(type, "answer");
         cur_stmts->push_back(answer);
@@ -2596,6 +2693,18 @@ int Fn_Def::codegen_pareto_comparator_all_dim(
         if_equal->els.push_back(ret_lesser);
   }
 
+  if (packable) {
+    // same extraction of the dimensions as in the comparator, without
+    // the dimension switch
+    for (std::list<Statement::Base*>::iterator j = comp.stmts.begin();
+         j != comp.stmts.end(); ++j) {
+      if (*j != dim && *j != sw) {
+        comp.key_stmts.push_back(*j);
+      }
+    }
+    comp.key_stmts.insert(comp.key_stmts.end(), keys.begin(), keys.end());
+  }
+
   Statement::Return *ret_cond = new Statement::Return(new Expr::Const(
     new Const::Int(-1)));
   comp.stmts.push_back(ret_cond);
@@ -2644,9 +2753,12 @@ void Fn_Def::codegen_pareto_multi_yukish(Fn_Def &a, Fn_Def &b,
     stmts.push_back(ret);
 }
 
-// generates the comparator element needed for domination optimized nosort
+// generates the comparator element needed for domination optimized nosort,
+// fn is the rtlib front implementation: the sequential domination sort,
+// its parallel version, the epsilon-Pareto front or the runtime selection
+// between the exact ones
 void Fn_Def::codegen_pareto_domination_nosort(Fn_Def &a, Fn_Def &b,
-  Product::Two &product) {
+  Product::Two &product, Statement::Fn_Call::Builtin fn) {
     // create  a variable to put all answers in
     assert(stmts.empty());
     Statement::Var_Decl *answers = new Statement::Var_Decl(
@@ -2660,8 +2772,7 @@ void Fn_Def::codegen_pareto_domination_nosort(Fn_Def &a, Fn_Def &b,
     std::string* second = new std::string(*names.front());
     second->append(".second");
 
-    Statement::Fn_Call *pareto = new Statement::Fn_Call(
-      Statement::Fn_Call::PARETO_DOMINATION_SORT);
+    Statement::Fn_Call *pareto = new Statement::Fn_Call(fn);
     pareto->add_arg(*answers);
     pareto->add_arg(first);
     pareto->add_arg(second);
@@ -2959,6 +3070,11 @@ Mode Fn_Def::derive_role() const {
     r.set(Mode::CLASSIFY);
     return r;
   }
+  if (fn->builtin == Expr::Fn_Call::KMINIMUM ||
+      fn->builtin == Expr::Fn_Call::KMAXIMUM) {
+    r.set(Mode::KSCORING);
+    return r;
+  }
   if (fn->builtin != Expr::Fn_Call::LIST)
     return r;
   if (!fn->exprs.front()->is(Expr::FN_CALL))
@@ -34,6 +34,7 @@
 #include "mode.hh"
 
 #include "expr/fn_call.hh"
+#include "statement/fn_call.hh"
 
 #include "hashtable.hh"
 
@@ -104,7 +105,8 @@ class Fn_Def : public Fn_Decl {
       Fn_Decl(r, n, l), gen_type(STANDARD),
       comperator_suffix(new std::string("_comperator")),
       sorter_suffix(new std::string("_sorter")), nullary_sort_ob(NULL),
-      adaptor(NULL), comparator(NULL), sorter(NULL),
+      adaptor(NULL), comparator(NULL), sorter(NULL), lazy_left(NULL),
+      lazy_right(NULL),
       choice_fn_type_(Expr::Fn_Call::NONE) {
     }
 
@@ -113,7 +115,8 @@ class Fn_Def : public Fn_Decl {
       Fn_Decl(r, n), gen_type(STANDARD),
       comperator_suffix(new std::string("_comperator")),
       sorter_suffix(new std::string("_sorter")), nullary_sort_ob(NULL),
-      adaptor(NULL), comparator(NULL), sorter(NULL),
+      adaptor(NULL), comparator(NULL), sorter(NULL), lazy_left(NULL),
+      lazy_right(NULL),
       choice_fn_type_(Expr::Fn_Call::NONE) {
     }
 
@@ -124,7 +127,8 @@ class Fn_Def : public Fn_Decl {
     Fn_Def() : Fn_Decl(), gen_type(STANDARD),
       comperator_suffix(new std::string("_comperator")),
       sorter_suffix(new std::string("_sorter")), nullary_sort_ob(NULL),
-      adaptor(NULL), comparator(NULL),  sorter(NULL),
+      adaptor(NULL), comparator(NULL),  sorter(NULL), lazy_left(NULL),
+      lazy_right(NULL),
       choice_fn_type_(Expr::Fn_Call::NONE) {
     }
 
@@ -160,6 +164,12 @@ class Fn_Def : public Fn_Decl {
     Operator *comparator;
                 Operator *sorter;
 
+    // evaluates just the left component of a product algebra function,
+    // see Product::Base::set_lazy()
+    Fn_Def *lazy_left;
+    // completes the candidate from the result of lazy_left
+    Fn_Def *lazy_right;
+
 
 
     void times_cg_with_rhs_choice(
@@ -215,7 +225,8 @@ class Fn_Def : public Fn_Decl {
     void codegen_pareto_multi_yukish(
       Fn_Def &a, Fn_Def &b, Product::Two &product, int cutoff, int dim);
     void codegen_pareto_domination_nosort(
-      Fn_Def &a, Fn_Def &b, Product::Two &product);
+      Fn_Def &a, Fn_Def &b, Product::Two &product,
+      Statement::Fn_Call::Builtin fn);
     void codegen_pareto_lex(Fn_Def &a, Fn_Def &b, Product::Two &product);
     void codegen_nop(Product::Two &product);
     void codegen_cartesian(Fn_Def &a, Fn_Def &b, Product::Two &product);
@@ -93,11 +93,49 @@ static void parse_options(int argc, char **argv, Options *rec) {
     ("kbacktrace", "backtracing for k-scoring lhs")
     ("subopt-classify", "classified dp")
     ("subopt", "generate suboptimal backtracing code (needs foo * pretty)")
+    ("subopt-stream", "like --subopt, but enumerate the candidates depth "
+      "first and print each one as soon as it is complete (Wuchty style), "
+      "instead of collecting all of them first")
     ("sample", "generate stochastic backtracing code")
+    ("sample-cache", "like --sample, but reuse the discrete distribution of "
+      "each visited cell in the following samples instead of preprocessing "
+      "it again (up to SAMPLE_CACHE_BYTES, default 256 MiB per thread)")
+    ("sample-batch", "like --sample, but draw the -r samples together: each "
+      "cell splits its share of the samples multinomially among its "
+      "candidates and each chosen candidate is backtraced once")
+    ("lazy-kbest", "with kminimum/kmaximum choice fns, enumerate the "
+      "candidates of an alternative over several sub-answer lists best first "
+      "and stop after the k best (Huang-Chiang), instead of evaluating the "
+      "whole cross product; needs algebra fns that are monotone in these "
+      "arguments")
     ("no-coopt", "with kbacktrace, don't output cooptimal candidates")
     ("no-coopt-class", "with kbacktrace, don't output cooptimal candidates")
     ("window-mode,w", "window mode")
     ("kbest", "classify the k-best classes only")
+    ("soa-tables", "store tuple answers of tables component-wise (struct of "
+      "arrays), if the answer width is fixed")
+    ("lazy-product", "for A * B, evaluate B only for candidates surviving the "
+      "choice of A")
+    ("pareto-stream", "for A ^ B of two numeric minimum/maximum algebras, "
+      "reject dominated candidates already when they are pushed")
+    ("swiss-hash", "use open addressing hash tables with SIMD probing for "
+      "the classified answer lists of --kbest and --subopt-classify")
+    ("intern-shapes", "store every distinct shape once and represent shapes "
+      "by integer ids, i.e. memoise shape concatenation")
+    ("small-shapes", "store shapes of up to 29 symbols '[', ']' and '_' "
+      "inline, i.e. without heap allocation")
+    ("small-ropes", "store ropes of up to 30 characters inline, i.e. "
+      "without allocating and reference counting a block")
+    ("defer-pretty", "if the RHS of the product is a pretty printing "
+      "algebra, build its answers by backtracing, i.e. only for the "
+      "printed candidates")
+    ("adaptive-hash", "pre-size the classified answer lists of --kbest and "
+      "--subopt-classify from the class counts observed so far per "
+      "non-terminal and subword length (persisted in the file named by "
+      "GAPC_HASH_SIZES, if set)")
+    ("fuse", po::value< std::vector<std::string> >(),
+      "compute several instances (each with a single answer per "
+      "sub-problem) in one grammar traversal; provide multiple times")
     ("ambiguity",
       "converts the selected instance into a context free string grammar")
     ("specialize_grammar",
@@ -119,7 +157,11 @@ static void parse_options(int argc, char **argv, Options *rec) {
     ("version,v", "version string")
     ("pareto-version,P", po::value<int>(),
       "Implementation of Pareto Product to use 0 (NoSort), 1 (Sort), 2 (ISort)"
-      ", 3 (MultiDimOptimized), 4 (NoSort, domination ordered) ")
+      ", 3 (MultiDimOptimized), 4 (NoSort, domination ordered), 5 (NoSort, "
+      "domination ordered, parallel merge of large candidate lists), 6 "
+      "(epsilon-Pareto, approximate front, epsilon is set at runtime), 7 "
+      "(Auto, times the exact front implementations on the first cells and "
+      "uses the fastest) ")
     ("multi-dim-pareto",
       "Use multi-dimensional Pareto. Works with -P 0, -P 1 and -P 3.")
     ("cut-off,c", po::value<int>(),
@@ -218,14 +260,24 @@ static void parse_options(int argc, char **argv, Options *rec) {
     rec->includes = vm["include"].as< std::vector<std::string> >();
   if (vm.count("cyk"))
     rec->cyk = true;
-  if (vm.count("backtrack") || vm.count("backtrace") || vm.count("sample"))
+  if (vm.count("backtrack") || vm.count("backtrace") || vm.count("sample") ||
+      vm.count("sample-cache") || vm.count("sample-batch"))
     rec->backtrack = true;
-  if (vm.count("sample"))
+  if (vm.count("sample") || vm.count("sample-cache") ||
+      vm.count("sample-batch"))
     rec->sample = true;
-  if (vm.count("subopt"))
+  if (vm.count("sample-cache"))
+    rec->sample_cache = true;
+  if (vm.count("sample-batch"))
+    rec->sample_batch = true;
+  if (vm.count("subopt") || vm.count("subopt-stream"))
     rec->subopt = true;
+  if (vm.count("subopt-stream"))
+    rec->subopt_stream = true;
   if (vm.count("kbacktrack") || vm.count("kbacktrace"))
     rec->kbacktrack = true;
+  if (vm.count("lazy-kbest"))
+    rec->lazy_kbest = true;
   if (vm.count("no-coopt"))
     rec->no_coopt = true;
   if (vm.count("no-coopt-class"))
@@ -236,6 +288,30 @@ static void parse_options(int argc, char **argv, Options *rec) {
     rec->window_mode = true;
   if (vm.count("kbest"))
     rec->kbest = true;
+  if (vm.count("soa-tables"))
+    rec->soa_tables = true;
+  if (vm.count("lazy-product"))
+    rec->lazy_product = true;
+  if (vm.count("pareto-stream"))
+    rec->pareto_stream = true;
+  if (vm.count("swiss-hash"))
+    rec->swiss_hash = true;
+  if (vm.count("intern-shapes"))
+    rec->intern_shapes = true;
+  if (vm.count("small-shapes"))
+    rec->small_shapes = true;
+  if (vm.count("small-ropes"))
+    rec->small_ropes = true;
+  if (vm.count("defer-pretty"))
+    rec->defer_pretty = true;
+  if (vm.count("adaptive-hash"))
+    rec->adaptive_hash = true;
+  if (vm.count("fuse")) {
+    if (vm.count("instance") || vm.count("product")) {
+      throw LogError("--fuse cannot be combined with --instance or --product");
+    }
+    rec->fuse = vm["fuse"].as< std::vector<std::string> >();
+  }
   if (vm.count("ambiguity")) {
     rec->ambiguityCheck = true;
   }
@@ -328,6 +404,52 @@ class Main {
     }
   }
 
+  // With --defer-pretty, a product A * B whose RHS only pretty prints
+  // is compiled like with --backtrace: the forward pass just computes
+  // A and the B strings are built from the backtrace, i.e. only for the
+  // reported candidates and not for every candidate of every cell.
+  void conv_deferred_pretty(Options *opts) {
+    if (!opts->defer_pretty || opts->classified || opts->backtrack ||
+        opts->kbacktrack || opts->subopt || opts->sample ||
+        !opts->fuse.empty() || driver.ast.outside_generation()) {
+      return;
+    }
+    Instance *instance = driver.ast.instance(opts->instance);
+    if (!instance || !instance->product->is(Product::TIMES)) {
+      return;
+    }
+    Product::Base *l = instance->product->left();
+    Product::Base *r = instance->product->right();
+    if (!r->is(Product::SINGLE) || !r->algebra()->is_compatible(Mode::PRETTY)
+        || !l->contains_only_times() || l->contains(Product::OVERLAY)) {
+      Log::instance()->verboseMessage(
+        "--defer-pretty: the RHS of the product is no pretty printing "
+        "algebra, strings are computed in the forward pass.");
+      return;
+    }
+    for (Product::iterator i = Product::begin(l); i != Product::end(); ++i) {
+      if (!(*i)->is(Product::SINGLE)) {
+        continue;
+      }
+      Algebra *a = (*i)->algebra();
+      for (hashtable<std::string, Fn_Def*>::iterator j =
+           a->choice_fns.begin(); j != a->choice_fns.end(); ++j) {
+        // backtracing reproduces the pretty print of a single optimal
+        // candidate only, i.e. neither k-scoring nor synoptic (e.g.
+        // counting) LHS algebras qualify
+        Expr::Fn_Call::Builtin t = j->second->choice_fn_type();
+        if ((t != Expr::Fn_Call::MINIMUM && t != Expr::Fn_Call::MAXIMUM) ||
+            j->second->choice_mode() == Mode::MANY) {
+          Log::instance()->verboseMessage(
+            "--defer-pretty: the LHS of the product is no minimum/maximum "
+            "scoring algebra, strings are computed in the forward pass.");
+          return;
+        }
+      }
+    }
+    opts->backtrack = true;
+  }
+
  private:
   /*
    * The front end of the compiler. This method parses all
@@ -372,6 +494,15 @@ class Main {
       throw LogError("Seen parse errors.");
     }
 
+    if (!opts.fuse.empty()) {
+      if (opts.backtrack || opts.subopt || opts.kbacktrack || opts.sample) {
+        throw LogError("--fuse cannot be combined with backtracing.");
+      }
+      if (!driver.ast.fuse_instances(opts.fuse)) {
+        throw LogError("Seen instance errors.");
+      }
+    }
+
     // simply gets the selected grammar, which is either the
     // grammar that occured first in the source code or is the
     // one that was named in the parameters on the command line
@@ -394,6 +525,15 @@ class Main {
     // configure the window and k-best mode
     driver.ast.set_window_mode(opts.window_mode);
     driver.ast.kbest = Bool(opts.kbest);
+    driver.ast.lazy_kbest = Bool(opts.lazy_kbest);
+    driver.ast.soa_tables = Bool(opts.soa_tables);
+    driver.ast.swiss_hash = Bool(opts.swiss_hash);
+    driver.ast.intern_shapes = Bool(opts.intern_shapes);
+    driver.ast.small_shapes = Bool(opts.small_shapes);
+    driver.ast.small_ropes = Bool(opts.small_ropes);
+    driver.ast.adaptive_hash = Bool(opts.adaptive_hash);
+    driver.ast.sample_cache = Bool(opts.sample_cache);
+    driver.ast.sample_batch = Bool(opts.sample_batch);
 
     if (opts.cyk) {
       driver.ast.set_cyk();
@@ -473,8 +613,10 @@ class Main {
     bool nullarySort = false;
     if (opts.pareto > 0) {
         driver.ast.set_pareto_version(*instance, opts.pareto);
+        driver.ast.pareto_eps = Bool(opts.pareto == 6);
 
-        if (opts.pareto == 1 || opts.pareto == 3 || opts.pareto == 4) {
+        if (opts.pareto == 1 || opts.pareto == 3 || opts.pareto == 4 ||
+            opts.pareto == 5 || opts.pareto == 6 || opts.pareto == 7) {
             nullarySort = true;
             if ((opts.backtrack || opts.subopt || opts.kbacktrack)) {
               if (opts.multiDimPareto) {
@@ -552,7 +694,8 @@ class Main {
 
     if (opts.multiDimPareto) {
          if (opts.pareto == 0 || opts.pareto == 1 || opts.pareto == 3 ||
-             opts.pareto == 4) {
+             opts.pareto == 4 || opts.pareto == 5 || opts.pareto == 6 ||
+             opts.pareto == 7) {
              driver.ast.set_pareto_dim(*instance, true);
          } else {
             throw LogError(
@@ -573,6 +716,11 @@ class Main {
     if (opts.no_coopt_class) {
       driver.ast.instance_->product->set_no_coopt_class();
     }
+    if (opts.lazy_product && !driver.ast.instance_->product->set_lazy()) {
+      Log::instance()->warning(
+        "--lazy-product is ignored, it needs a product A * B of a single "
+        "left algebra A.");
+    }
 
     bool r = driver.ast.insert_instance(instance);
     if (!r) {
@@ -659,6 +807,9 @@ class Main {
 
     if (opts.specialization == 0) {
         driver.ast.optimize_choice(*instance);
+        if (opts.pareto_stream) {
+          driver.ast.optimize_pareto_choice(*instance);
+        }
         driver.ast.optimize_classify(*instance);
     } else {
         Log::instance()->warning(
@@ -723,7 +874,7 @@ class Main {
     if (opts.backtrack) {
       bt = std::unique_ptr<Backtrack_Base>(new Backtrack());
     } else if (opts.subopt) {
-      bt = std::unique_ptr<Backtrack_Base>(new Subopt());
+      bt = std::unique_ptr<Backtrack_Base>(new Subopt(opts.subopt_stream));
     } else if (opts.kbacktrack) {
       bt = std::unique_ptr<Backtrack_Base>(new KBacktrack());
     } else if (opts.classified) {
@@ -786,6 +937,7 @@ class Main {
     makefile();
 
     conv_classified_product(&opts);
+    conv_deferred_pretty(&opts);
 
     if (opts.classified) {
       std::string class_name = opts.class_name;
@@ -799,12 +951,17 @@ class Main {
 
       // FIXME init marker code in buddy ...
 
-      opts.cyk = false;
       opts.class_name = class_name;
       opts.classified = false;
       opts.kbacktrack = kbacktrack;
       driver.ast.check_instances(r.second);
       Code::Mode mode;
+      // the classified instance is filled bottom up (and in parallel) as
+      // well, the marker condition of each NT rejects the subproblems
+      // that the buddy did not mark
+      if (opts.cyk) {
+        mode = Code::Mode::CYK;
+      }
       mode.set_subopt_buddy();
       driver.ast.set_code_mode(mode);
 
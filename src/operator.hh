@@ -60,6 +60,10 @@ class Operator {
   // The list of statements of the operator function
   std::list<Statement::Base*> stmts;
 
+  // if not empty: statements of a keys function, which stores a numeric
+  // key (smaller is better) of each dimension of e1 in k
+  std::list<Statement::Base*> key_stmts;
+
 
   Operator(Type::Base *r, std::string *ob) :
       return_type(r),  object(ob) {
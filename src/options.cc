@@ -86,14 +86,29 @@ bool Options::check() {
     Log::instance()->error(
       "Currently --window-mode is just possible without --cyk.");
 
+  if (swiss_hash && checkpointing)
+    Log::instance()->error("Can't combine --swiss-hash with --checkpoint");
+
+  if (intern_shapes && checkpointing)
+    Log::instance()->error("Can't combine --intern-shapes with --checkpoint");
+
+  if (small_shapes && checkpointing)
+    Log::instance()->error("Can't combine --small-shapes with --checkpoint");
+
+  if (small_ropes && checkpointing)
+    Log::instance()->error("Can't combine --small-ropes with --checkpoint");
+
+  if (small_shapes && intern_shapes)
+    Log::instance()->error("Use either --small-shapes or --intern-shapes");
+
   if (classified && kbest)
     Log::instance()->error("Use either --subopt-classify or --kbest");
 
   if (logLevel < 0 || logLevel > 4)
     Log::instance()->error("Log-level must be in the range of 0 to 4.");
 
-  if (pareto < 0 || pareto > 4)
-    Log::instance()->error("Pareto version must be in the range of 0 to 4.");
+  if (pareto < 0 || pareto > 7)
+    Log::instance()->error("Pareto version must be in the range of 0 to 7.");
 
   if (cutoff < 10 )
     Log::instance()->error("Cut-off must be bigger than 10.");
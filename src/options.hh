@@ -43,13 +43,25 @@ struct Options {
   Options()
     :  inline_nts(false), out(NULL), h_stream_(NULL), m_stream_(NULL),
       approx_table_design(false), tab_everything(false),
-      cyk(false), backtrack(false), sample(false), subopt(false),
+      cyk(false), backtrack(false), sample(false), sample_cache(false),
+      sample_batch(false), subopt(false),
+      subopt_stream(false),
       kbacktrack(false),
+      lazy_kbest(false),
       no_coopt(false),
       no_coopt_class(false),
       classified(false),
       window_mode(false),
       kbest(false),
+      soa_tables(false),
+      lazy_product(false),
+      pareto_stream(false),
+      swiss_hash(false),
+      intern_shapes(false),
+      small_shapes(false),
+      small_ropes(false),
+      adaptive_hash(false),
+      defer_pretty(false),
       ambiguityCheck(false),
       specializeGrammar(false),
       verbose_mode(false),
@@ -94,8 +106,17 @@ struct Options {
   bool cyk;
   bool backtrack;
   bool sample;
+  // reuse the alias tables of the sampled cells (rtlib/sample.hh)
+  bool sample_cache;
+  // draw all samples in one backtrace (rtlib/sample.hh)
+  bool sample_batch;
   bool subopt;
+  // enumerate the --subopt candidates depth first (rtlib/subopt.hh)
+  bool subopt_stream;
   bool kbacktrack;
+  // enumerate the candidates of kminimum/kmaximum alternatives lazily
+  // (rtlib/top_k.hh)
+  bool lazy_kbest;
   std::vector<std::string> tab_list;
   bool no_coopt;
   bool no_coopt_class;
@@ -107,6 +128,39 @@ struct Options {
 
   bool kbest;
 
+  bool soa_tables;
+
+  // evaluate the right algebra of A * B only for candidates that survive
+  // the choice of the left algebra
+  bool lazy_product;
+
+  // keep the candidate lists of 2D Pareto choice fns as fronts while
+  // pushing
+  bool pareto_stream;
+
+  // back the hashed answer lists of --kbest/--subopt-classify by
+  // open addressing tables (rtlib/hash_swiss.hh)
+  bool swiss_hash;
+
+  // represent shapes by ids into a global table (rtlib/shape_intern.hh)
+  bool intern_shapes;
+
+  // store short shapes inline in a machine word (rtlib/shape_small.hh)
+  bool small_shapes;
+
+  // store short ropes inline (rtlib/rope_small.hh)
+  bool small_ropes;
+
+  // learn the number of classes per non-terminal and subword length
+  // at runtime and allocate the hashed answer lists accordingly
+  bool adaptive_hash;
+
+  // switch to backtracing if the RHS of the product pretty prints
+  bool defer_pretty;
+
+  // names of the instances that are computed in one grammar traversal
+  std::vector<std::string> fuse;
+
   // Flag that signals if an ambiguity-cfg should be generated.
   // The name of the instance that is used to generate the string
   // grammar from the gapc-grammar is set as always: select nothing
@@ -128,7 +128,8 @@ bool is_terminal_type(Type::Base *t) {
       (t->is(Type::RATIONAL))) {
     return true;
   }
-  if ((t->is(Type::BIGINT)) || (t->is(Type::SHAPE)) || (t->is(Type::INTEGER))) {
+  if ((t->is(Type::BIGINT)) || (t->is(Type::SHAPE)) ||
+      (t->is(Type::DOTBRACKET)) || (t->is(Type::INTEGER))) {
     return false;
   }
   if ((t->is(Type::EXTERNAL)) || (t->is(Type::TUPLEDEF))) {
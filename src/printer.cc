@@ -99,6 +99,7 @@ void Printer::Base::print(const Type::Seq &t) {}
 void Printer::Base::print(const Type::Table &t) {}
 void Printer::Base::print(const Type::Subseq &t) {}
 void Printer::Base::print(const Type::Shape &t) {}
+void Printer::Base::print(const Type::DotBracket &t) {}
 void Printer::Base::print(const Type::Referencable &t) {}
 void Printer::Base::print(const Type::Rational &t) {}
 void Printer::Base::print(const Type::BigInt &t) {}
@@ -153,6 +153,7 @@ class Base {
   virtual void print(const Type::Table &expr);
   virtual void print(const Type::Subseq &expr);
   virtual void print(const Type::Shape &expr);
+  virtual void print(const Type::DotBracket &expr);
   virtual void print(const Type::Referencable &expr);
   virtual void print(const Type::BigInt &expr);
   virtual void print(const Type::Rational &expr);
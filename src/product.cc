@@ -386,6 +386,15 @@ void Product::Pareto::set_pareto_type(int i) {
     case 4:
         pareto_type = Product::Pareto::NoSortDomOpt;
         break;
+    case 5:
+        pareto_type = Product::Pareto::ParallelDomOpt;
+        break;
+    case 6:
+        pareto_type = Product::Pareto::EpsDomOpt;
+        break;
+    case 7:
+        pareto_type = Product::Pareto::AutoDomOpt;
+        break;
     default:
         pareto_type = Product::Pareto::NoSort;
         break;
@@ -575,6 +584,14 @@ Product::Base *Product::Times::optimize_shuffle_products() {
   return this;
 }
 
+// Only for A * B with a single left algebra, the left component of a
+// candidate is a score which can be compared against the current
+// choice before the right component is evaluated.
+bool Product::Base::set_lazy() {
+  lazy_ = Bool(is(TIMES) && left()->is(SINGLE));
+  return lazy_;
+}
+
 Mode & Product::Two::left_mode(const std::string &s) {
   hashtable<std::string, Fn_Def*>::iterator i =
     l->algebra()->choice_fns.find(s);
@@ -178,6 +178,15 @@ class Base {
   }
   static bool no_coopt_class() { return no_coopt_class_; }
 
+ protected:
+  // evaluate the left algebra of a lexicographic product first and the
+  // right one only for candidates that survive the left choice
+  Bool lazy_;
+
+ public:
+  bool set_lazy();
+  bool lazy() const { return lazy_; }
+
   virtual Base *replace_classified(bool &x) = 0;
 
   void set_adp_specialization(ADP_Mode::Adp_Specialization a) {
@@ -400,7 +409,8 @@ class Takeone : public Two {
 
 class Pareto : public Two {
  public:
-  enum ParetoType {NoSort, Sort, ISort, MultiDimOpt, NoSortDomOpt};
+  enum ParetoType {NoSort, Sort, ISort, MultiDimOpt, NoSortDomOpt,
+    ParallelDomOpt, EpsDomOpt, AutoDomOpt};
 
  private:
   ParetoType pareto_type;
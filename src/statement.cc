@@ -338,7 +338,8 @@ std::list<Statement::Base*> *Statement::Switch::add_case(std::string *n) {
 
 
 Statement::Foreach::Foreach(Var_Decl *i, Var_Decl *l)
-  : Block_Base(FOREACH), elem(i), container(l), iteration(true) {
+  : Block_Base(FOREACH), elem(i), container(l), iteration(true),
+    frontier(NULL), frontier_answers(NULL) {
   assert(elem);
   assert(container);
 }
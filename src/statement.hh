@@ -296,6 +296,12 @@ class Foreach : public Block_Base {
   Var_Decl *container;
   bool iteration;
 
+  // --lazy-kbest: this loop and the loops nested in it enumerate their
+  // elements best first through the Top_K_Frontier frontier, which pushes
+  // the candidates to frontier_answers
+  Var_Decl *frontier;
+  Var_Decl *frontier_answers;
+
   Foreach(Var_Decl *i, Var_Decl *l);
   void print(Printer::Base &p) const;
 
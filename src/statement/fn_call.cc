@@ -56,7 +56,12 @@ const char * Statement::Fn_Call::map_builtin_to_string[] = {
   "INNER",
   "mark_position",
   "join_marked",
-  "pareto_domination_sort"
+  "pareto_domination_sort",
+  "pareto_parallel",
+  "pareto_eps",
+  "pareto_auto",
+  "hash_hint",
+  "join_classes"
 };
 
 
@@ -48,7 +48,12 @@ class Fn_Call : public Base {
          INNER,
          MARK_POSITION,
          JOIN_MARKED,
-         PARETO_DOMINATION_SORT
+         PARETO_DOMINATION_SORT,
+         PARETO_PARALLEL,
+         PARETO_EPS,
+         PARETO_AUTO,
+         HASH_HINT,
+         JOIN_CLASSES
     };
 
 
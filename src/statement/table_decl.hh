@@ -44,6 +44,7 @@ class Table_Decl : public Base {
   ::Type::Base *pos_type_;
   std::string *name_;
   bool cyk_;
+  bool soa_;
 
   Fn_Def *fn_is_tab_;
   Fn_Def *fn_untab_;
@@ -70,6 +71,9 @@ class Table_Decl : public Base {
   const ::Type::Base &datatype() const { assert(type_); return *type_; }
   const ::Type::Base &pos_type() const { assert(pos_type_); return *pos_type_; }
   bool cyk() const { return cyk_; }
+  // answers are stored as struct of arrays, i.e. get returns by value
+  bool soa() const { return soa_; }
+  void set_soa(bool b) { soa_ = b; }
   const std::list<Statement::Var_Decl*> &ns() const { return ns_; }
 
   const Fn_Def &fn_is_tab() const { return *fn_is_tab_; }
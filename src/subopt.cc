@@ -147,14 +147,23 @@ void Subopt::gen_backtrack(AST &ast) {
   ast.grammar()->init_indices();
   ast.grammar()->init_decls("sub_");
 
-  ast.set_code_mode(Code::Mode(Code::Mode::UNGER, Code::Mode::SUBOPT));
+  Code::Mode mode(Code::Mode::UNGER, Code::Mode::SUBOPT);
+  if (stream) {
+    mode.set_subopt_stream();
+  }
+  ast.set_code_mode(mode);
   ast.codegen();
 
   const std::list<Symbol::NT*> l = ast.grammar()->nts();
   for (std::list<Symbol::NT*>::const_iterator i = l.begin();
        i != l.end(); ++i) {
     Fn_Def *fn = (*i)->code();
-    fn->set_target_name("bt_" + *fn->name);
+    if (stream) {
+      gen_nt_proxy_fn(fn);
+      fn->set_target_name("bt_expand_" + *fn->name);
+    } else {
+      fn->set_target_name("bt_" + *fn->name);
+    }
     if ((*i)->eval_fn) {
       assert(score_algebra);
       hashtable<std::string, Fn_Def*>::iterator j =
@@ -166,6 +175,86 @@ void Subopt::gen_backtrack(AST &ast) {
   }
 }
 
+void Subopt::gen_nt_decls(const std::list<Symbol::NT*> &nts) {
+  if (!stream) {
+    Backtrack_Base::gen_nt_decls(nts);
+    return;
+  }
+  // the slots remember the optimal score of their sub-problem
+  for (std::list<Symbol::NT*>::const_iterator i = nts.begin();
+       i != nts.end(); ++i) {
+    bt_nt_decls.push_back(
+      new Statement::Backtrace_NT_Decl(*(*i), (*i)->data_type()));
+  }
+}
+
+// bt_nt_X(..., global_score, delta) returns the optimal score of the
+// sub-problem together with a Backtrace_nt_X slot - instead of all its
+// candidates within delta
+void Subopt::gen_nt_proxy_fn(Fn_Def *fn) {
+  ::Type::Base *t = fn->return_type->deref();
+  bool is_list = t->is(::Type::LIST);
+
+  Fn_Def *f = fn->copy_head(t, new std::string("bt_" + *fn->name));
+
+  // without global_score and delta
+  std::list<std::string*> names(f->names.begin(), f->names.end());
+  names.pop_back();
+  names.pop_back();
+
+  Statement::Var_Decl *list = new Statement::Var_Decl(t, "l");
+  f->stmts.push_back(list);
+
+  Statement::Var_Decl *ret = 0;
+  if (is_list) {
+    ::Type::List *l = dynamic_cast< ::Type::List*>(t);
+    assert(l->of->is(::Type::TUPLE));
+    ret = new Statement::Var_Decl(l->of, "ret");
+  } else {
+    ret = new Statement::Var_Decl(t, "ret");
+  }
+  f->stmts.push_back(ret);
+
+  Expr::Fn_Call *nt_fn = new Expr::Fn_Call(fn->name);
+  for (std::list<std::string*>::iterator i = names.begin();
+       i != names.end(); ++i) {
+    nt_fn->add_arg(*i);
+  }
+  Statement::Var_Assign *score =
+    new Statement::Var_Assign(new Var_Acc::Comp(*ret, 0), nt_fn);
+  f->stmts.push_back(score);
+
+  Expr::New *bt =
+    new Expr::New(new ::Type::Backtrace(fn->name, pos_type, value_type));
+  bt->add_arg(new Expr::This());
+  bt->add_args(names.begin(), names.end());
+  bt->add_arg(new Expr::Vacc(new Var_Acc::Comp(*ret, 0)));
+  Statement::Var_Assign *track =
+    new Statement::Var_Assign(new Var_Acc::Comp(*ret, 1), bt);
+
+  Expr::Fn_Call *empty = new Expr::Fn_Call(Expr::Fn_Call::IS_EMPTY);
+  empty->add_arg(new Var_Acc::Comp(*ret, 0));
+  Statement::Fn_Call *set_empty = new Statement::Fn_Call(
+    Statement::Fn_Call::EMPTY);
+  set_empty->add_arg(new Var_Acc::Comp(*ret, 1));
+  Statement::If *if_empty = new Statement::If(empty, set_empty, track);
+  f->stmts.push_back(if_empty);
+
+  if (is_list) {
+    Statement::Fn_Call *push =
+      new Statement::Fn_Call(Statement::Fn_Call::PUSH_BACK);
+    push->add_arg(*list);
+    push->add_arg(*ret);
+    if_empty->els.push_back(push);
+
+    f->stmts.push_back(new Statement::Return(*list));
+  } else {
+    f->stmts.push_back(new Statement::Return(*ret));
+  }
+
+  proxy_fns.push_back(f);
+}
+
 void Subopt::gen_instance_code(AST &ast) {
   instance->product->right_most()->codegen();
   // ast.optimize_choice(*instance);
@@ -223,6 +312,9 @@ void Subopt::print_header(Printer::Base &pp, AST &ast) {
     pp << **i;
 
   pp.begin_fwd_decls();
+  for (std::list<Fn_Def*>::iterator i = proxy_fns.begin();
+       i != proxy_fns.end(); ++i)
+    pp << **i;
   ast.print_code(pp);
 
   instance->product->right_most()->print_code(pp);
@@ -231,6 +323,9 @@ void Subopt::print_header(Printer::Base &pp, AST &ast) {
 }
 
 void Subopt::print_body(Printer::Base &pp, AST &ast) {
+  for (std::list<Fn_Def*>::iterator i = proxy_fns.begin();
+       i != proxy_fns.end(); ++i)
+    pp << **i;
   ast.print_code(pp);
 
   instance->product->right_most()->print_code(pp);
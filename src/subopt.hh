@@ -25,6 +25,8 @@
 #define SRC_SUBOPT_HH_
 
 
+#include <list>
+
 #include "backtrack_base.hh"
 #include "printer_fwd.hh"
 
@@ -34,10 +36,19 @@ class Fn_Def;
 
 class Subopt : public Backtrack_Base {
  private:
+    // --subopt-stream: each bt_nt_ fn just returns a slot for its
+    // sub-problem, the slots expand it via bt_expand_nt_ on demand
+    bool stream;
+    std::list<Fn_Def*> proxy_fns;
+
     void adjust_list_types(Fn_Def *fn, Fn_Def *fn_type);
     void add_subopt_fn_args(Fn_Def *fn);
+    void gen_nt_proxy_fn(Fn_Def *fn);
 
  public:
+    explicit Subopt(bool s = false) : stream(s) {}
+
+    void gen_nt_decls(const std::list<Symbol::NT*> &nts);
     void gen_instance(Algebra *score);
     void gen_instance(Algebra *score, Product::Sort_Type sort);
     void gen_instance(Algebra *score, Product::Base *base,
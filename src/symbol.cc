@@ -981,6 +981,28 @@ void Symbol::NT::marker_code(const Code::Mode &mode,
   ret_stmts.push_back(c);
 }
 
+// --sample-cache: name the cell for the alias table cache of the sample
+// filter in the choice fn, see scil::sample_cell(); the candidates of a
+// parameterized nonterminal also depend on its arguments and the cells
+// of window mode move, thus these are not cached; like
+// scil::cell_key, up to two tracks
+void Symbol::NT::sample_cell_code(const AST &ast) {
+  if (!ntargs_.empty() || ast.window_mode || left_indices.size() > 2) {
+    return;
+  }
+  const std::list<Symbol::NT*> &nts = ast.grammar()->nts();
+  int id = std::distance(nts.begin(), std::find(nts.begin(), nts.end(), this));
+  Statement::Fn_Call *f = new Statement::Fn_Call("scil::sample_cell");
+  f->add_arg(new Expr::Const(id + 1));
+  std::vector<Expr::Base*>::const_iterator j = right_indices.begin();
+  for (std::vector<Expr::Base*>::const_iterator i = left_indices.begin();
+      i != left_indices.end(); ++i, ++j) {
+    f->add_arg(*i);
+    f->add_arg(*j);
+  }
+  ret_stmts.push_front(f);
+}
+
 void Symbol::NT::init_ret_stmts(Code::Mode mode) {
   assert(table_decl);
   ret_stmts.clear();
@@ -1012,7 +1034,7 @@ void Symbol::NT::init_ret_stmts(Code::Mode mode) {
     ret = new Expr::Vacc(*ret_decl);
   }
   Statement::Return *r = new Statement::Return(ret);
-  if (tabulated && mode != Code::Mode::BACKTRACK) {
+  if (tabulated && mode != Code::Mode::BACKTRACK && !mode.subopt_stream()) {
     Statement::Fn_Call *tabfn =
       new Statement::Fn_Call(Statement::Fn_Call::TABULATE);
     tabfn->add(*table_decl);
@@ -1077,6 +1099,7 @@ void Symbol::NT::init_table_decl(const AST &ast) {
 
   Tablegen tg;
   tg.set_window_mode(ast.window_mode);
+  tg.set_soa(ast.soa_tables);
   table_decl = tg.create(*this, t, ast.code_mode() == Code::Mode::CYK,
                          ast.checkpoint && !ast.checkpoint->is_buddy);
 }
@@ -1130,7 +1153,10 @@ void Symbol::NT::init_table_code(const Code::Mode &mode) {
 }
 
 void Symbol::NT::add_cyk_stub(AST &ast) {
-  ::Type::Base *dt = new ::Type::Referencable(datatype);
+  ::Type::Base *dt = datatype;
+  if (!table_decl->soa()) {
+    dt = new ::Type::Referencable(datatype);
+  }
   Fn_Def *f = new Fn_Def(dt, new std::string("nt_" + *name));
   f->add_para(*this);
   Expr::Fn_Call *get_tab = new Expr::Fn_Call(Expr::Fn_Call::GET_TABULATED);
@@ -1221,8 +1247,11 @@ void Symbol::NT::codegen(AST &ast) {
   set_ret_decl_rhs(ast.code_mode());
   init_table_decl(ast);
   init_zero_decl();
+  // with --subopt-stream the answers depend on the remaining delta, i.e.
+  // they can't be tabulated
+  bool tab = tabulated && !ast.code_mode().subopt_stream();
   ::Type::Base *dt = datatype;
-  if (tabulated) {
+  if (tab) {
     dt = new ::Type::Referencable(datatype);
   }
   Fn_Def *f = 0;
@@ -1241,7 +1270,7 @@ void Symbol::NT::codegen(AST &ast) {
   init_table_code(ast.code_mode());
 
   stmts.insert(stmts.begin(), guards.begin(), guards.end());
-  if (!ast.cyk() && tabulated) {
+  if (!ast.cyk() && tab) {
     stmts.insert(stmts.begin(), table_guard.begin(), table_guard.end());
   }
 
@@ -1300,6 +1329,10 @@ void Symbol::NT::codegen(AST &ast) {
   }
 
   init_ret_stmts(ast.code_mode());
+  if (ast.sample_cache && ast.code_mode() == Code::Mode::BACKTRACK &&
+      eval_decl) {
+    sample_cell_code(ast);
+  }
   stmts.insert(stmts.end(), ret_stmts.begin(), ret_stmts.end());
   f->stmts = stmts;
 
@@ -1398,6 +1431,38 @@ void Symbol::NT::optimize_choice(::Type::List::Push_Type push) {
   l = dynamic_cast< ::Type::List*>(datatype);
   if (l)
     l->set_push_type(push);
+
+  if (push >= ::Type::List::PARETO_MIN_MIN) {
+    finalize_front();
+  }
+}
+
+// --pareto-stream keeps the front of the answer list in a tree while the
+// alternatives push into it, see rtlib/pareto_stream.hh; it is moved into
+// the list before the choice fn, the table or the caller sees it
+void Symbol::NT::finalize_front() {
+  for (std::list<Fn_Def*>::iterator f = code_.begin(); f != code_.end();
+       ++f) {
+    std::list<Statement::Base*> &l = (*f)->stmts;
+    std::list<Statement::Base*>::iterator i =
+      std::find(l.begin(), l.end(), ret_decl);
+    for (; i != l.end(); ++i) {
+      Statement::Base *x = *i;
+      bool end = x->is(Statement::RETURN);
+      if (x->is(Statement::VAR_DECL)) {
+        end = *dynamic_cast<Statement::Var_Decl*>(x)->name == "eval";
+      }
+      if (x->is(Statement::FN_CALL)) {
+        end = dynamic_cast<Statement::Fn_Call*>(x)->builtin ==
+          Statement::Fn_Call::TABULATE;
+      }
+      if (end) {
+        l.insert(i, new Statement::Fn_Call(
+          Statement::Fn_Call::FINALIZE, *ret_decl));
+        break;
+      }
+    }
+  }
 }
 
 void Symbol::NT::optimize_choice(::Type::List::Push_Type push,
@@ -377,6 +377,9 @@ class NT : public Base {
     void set_grammar_index(size_t i) {
       grammar_index_ = i;
     }
+    size_t grammar_index() const {
+      return grammar_index_;
+    }
 
     bool has_eval_fn() {
       return eval_fn;
@@ -469,6 +472,7 @@ class NT : public Base {
     void add_specialised_arguments(Statement::Fn_Call *fn, bool keep_coopt);
     void set_ret_decl_rhs(Code::Mode mode);
     void init_ret_stmts(Code::Mode mode);
+    void sample_cell_code(const AST &ast);
     std::list<Statement::Base*> table_guard;
     void init_table_decl(const AST &ast);
     void init_table_code(const Code::Mode &mode);
@@ -477,6 +481,7 @@ class NT : public Base {
     void replace(Statement::Var_Decl &decl, Statement::iterator begin,
                  Statement::iterator end);
     void eliminate_list_ass();
+    void finalize_front();
     void add_cyk_stub(AST &ast);
     void subopt_header(AST &ast, Fn_Def *score_code, Fn_Def *f,
                        std::list<Statement::Base*> &stmts);
@@ -50,7 +50,8 @@ Tablegen::Tablegen()
   dtype(0),
   cyk_(false),
   window_mode_(false),
-  checkpoint_(false) {
+  checkpoint_(false),
+  soa_(false) {
   // FIXME?
   type = new ::Type::Size();
 
@@ -366,6 +367,9 @@ Statement::Table_Decl *Tablegen::create(Symbol::NT &nt,
   // dtype = nt.data_type()->clone();
   dtype = nt.data_type();
 
+  // the checkpointing code serializes the array as a whole
+  soa_ = soa_ && !checkpoint && soa_type(dtype);
+
   ret_zero = new Statement::Return(new Expr::Const(new Const::Bool(true)));
   offset(nt.track_pos(), nt.tables().begin(), nt.tables().end());
   Fn_Def *fn_is_tab = gen_is_tab();
@@ -385,9 +389,31 @@ Statement::Table_Decl *Tablegen::create(Symbol::NT &nt,
       fn_is_tab, fn_tab, fn_get_tab, fn_size,
       ns);
   td->set_fn_untab(fn_untab);
+  td->set_soa(soa_);
   return td;
 }
 
+// A tuple answer of fixed width, i.e. without any list component, can
+// be stored component-wise.
+bool Tablegen::soa_type(::Type::Base *t) {
+  ::Type::Tuple *tuple = dynamic_cast< ::Type::Tuple*>(t->simple());
+  if (!tuple) {
+    return false;
+  }
+  for (::Type::Tuple::Tuple_List::iterator i = tuple->list.begin();
+       i != tuple->list.end(); ++i) {
+    ::Type::Base *c = (*i)->first->lhs->simple();
+    if (c->is(::Type::TUPLE)) {
+      if (!soa_type(c)) {
+        return false;
+      }
+    } else if (c->is(::Type::LIST)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 #include "fn_def.hh"
 #include "var_acc.hh"
 
@@ -506,7 +532,12 @@ Fn_Def *Tablegen::gen_tab() {
 }
 
 Fn_Def *Tablegen::gen_get_tab() {
-  Fn_Def *f = new Fn_Def(new Type::Referencable(dtype), new std::string("get"));
+  // a struct of arrays table has no answer object to reference
+  Type::Base *rtype = dtype;
+  if (!soa_) {
+    rtype = new Type::Referencable(dtype);
+  }
+  Fn_Def *f = new Fn_Def(rtype, new std::string("get"));
   f->add_paras(paras);
 
   std::list<Statement::Base*> c;
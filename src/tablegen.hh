@@ -68,6 +68,7 @@ class Tablegen {
     bool cyk_;
     bool window_mode_;
     bool checkpoint_;
+    bool soa_;
 
     void head(Expr::Base *&i, Expr::Base *&j, Expr::Base *&n,
       const Table &table, size_t track);
@@ -88,10 +89,14 @@ class Tablegen {
     Fn_Def *gen_get_tab();
     Fn_Def *gen_size();
 
+    static bool soa_type(::Type::Base *t);
+
  public:
     Tablegen();
 
     void set_window_mode(bool b) { window_mode_ = b; }
+    // store tuple answers component-wise, if their width is fixed
+    void set_soa(bool b) { soa_ = b; }
 
     void offset(size_t track_pos, itr first, const itr &end);
 
@@ -143,6 +143,10 @@ void Type::add_predefined(hashtable<std::string, Base*> &table) {
   s = "shape";
   table[s] = t;
 
+  t = new ::Type::DotBracket();
+  s = "dotbracket";
+  table[s] = t;
+
   t = new ::Type::Rational();
   s = "rational";
   table[s] = t;
@@ -667,6 +671,12 @@ std::string Type::List::push_str() const {
     case MAX_OTHER : return std::string("max_other");
     case MIN_SUBOPT: return std::string("min_subopt");
     case MAX_SUBOPT: return std::string("max_subopt");
+    case KMIN : return std::string("kmin");
+    case KMAX : return std::string("kmax");
+    case PARETO_MIN_MIN : return std::string("pareto_min_min");
+    case PARETO_MIN_MAX : return std::string("pareto_min_max");
+    case PARETO_MAX_MIN : return std::string("pareto_max_min");
+    case PARETO_MAX_MAX : return std::string("pareto_max_max");
 
     case HASH : std::abort(); return std::string();
   }
@@ -702,6 +712,11 @@ void Type::Shape::print(Printer::Base &s) const {
 }
 
 
+void Type::DotBracket::print(Printer::Base &s) const {
+  s.print(*this);
+}
+
+
 void Type::Rational::print(Printer::Base &s) const {
   s.print(*this);
 }
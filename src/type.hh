@@ -85,7 +85,8 @@ bool set_if_compatible(Base * &a, Base *b, const Loc &l1, const Loc &l2);
 class List : public Base {
  public:
     enum Push_Type {NORMAL, MIN, MAX, SUM, MIN_OTHER, MAX_OTHER, MIN_SUBOPT,
-                    MAX_SUBOPT, HASH };
+                    MAX_SUBOPT, HASH, KMIN, KMAX, PARETO_MIN_MIN,
+                    PARETO_MIN_MAX, PARETO_MAX_MIN, PARETO_MAX_MAX };
 
  private:
     Push_Type push_type_;
@@ -456,6 +457,18 @@ class Shape : public Generic {
 };
 
 
+// packed secondary structure string of pretty printing algebras
+class DotBracket : public Generic {
+ public:
+    MAKE_CLONE(DotBracket);
+    DotBracket() : Generic(DOTBRACKET) { name = "dotbracket"; }
+    explicit DotBracket(const Loc &l) : Generic(DOTBRACKET, l) {
+      name = "dotbracket";
+    }
+    void print(Printer::Base &s) const;
+};
+
+
 class Referencable : public Base {
  private:
  public:
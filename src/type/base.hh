@@ -46,6 +46,7 @@ enum Type { NONE, LIST, TUPLE, TUPLEDEF, SIGNATURE, ALPHABET, DEF,
       TABLE,
       SUBSEQ,
       SHAPE,
+      DOTBRACKET,
       REFERENCABLE,  // only hint to backend
       RATIONAL,
       BIGINT,
@@ -50,6 +50,7 @@ class Seq;
 class Table;
 class Subseq;
 class Shape;
+class DotBracket;
 class Referencable;
 class Rational;
 class BigInt;
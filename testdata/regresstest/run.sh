@@ -199,6 +199,60 @@ check_new_old_eq_twotrack()
   rm -f string.o
 }
 
+check_mode_eq()
+{
+  # compare the output of a code generation mode, i.e. $GAPC plus the
+  # flags $6, with the output of its baseline $GAPC - instead of a truth
+  # file; $7 optionally replaces the instance of the mode, - for none
+
+  if [[ `echo $1$3$5 | grep $FILTER` != $1$3$5  ]]; then
+    return
+  fi
+
+  # work around 1 sec timestamp filesystems ... WTF?!?
+  sleep 1
+
+  echo +------------------------------------------------------------------------------+
+  failed=0
+  temp=$failed
+
+  cpp_base=${1%%.*}
+  build_cpp $GRAMMAR/$1 $cpp_base $3
+  run_cpp $cpp_base $3 $4 $5.base
+
+  sleep 1
+  old_gapc=$GAPC
+  old_ignore=$IGNORE_INSTANCE
+  GAPC="$GAPC $6"
+  inst=$3
+  if [ $# -ge 7 ]; then
+    inst=$7
+    if [ $7 == "-" ]; then
+      IGNORE_INSTANCE="yes"
+    fi
+  fi
+  build_cpp $GRAMMAR/$1 $cpp_base $inst
+  GAPC=$old_gapc
+  IGNORE_INSTANCE=$old_ignore
+  run_cpp $cpp_base $3 $4 $5
+
+  log1 s sort $cpp_base.$3.$5.out
+  log1 a $SED '/Answer/d' s
+  log1 t sort $cpp_base.$3.$5.base.out
+  log1 b $SED '/Answer/d' t
+  log diff -u -w -B a b
+
+  if [ $temp != $failed ]; then
+    echo --++--FAIL--++--
+    err_count=$((err_count+1))
+  else
+    echo OK
+    succ_count=$((succ_count+1))
+  fi
+  echo +------------------------------------------------------------------------------+
+  rm -f string.o
+}
+
 run_check_feature()
 {
   out=$1.$2.$3.$4
@@ -0,0 +1,113 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE arena
+#include <iostream>
+#include <vector>
+#include <set>
+#include <thread>
+#include <boost/test/unit_test.hpp>
+
+#define USE_ARENA
+#include "../../rtlib/pool.hh"
+#include "../../rtlib/multipool.hh"
+
+#include "macros.hh"
+
+
+BOOST_AUTO_TEST_CASE(reuse) {
+  Arena::Heap heap;
+  size_t *a = static_cast<size_t*>(heap.malloc(sizeof(size_t)));
+  size_t *b = static_cast<size_t*>(heap.malloc(sizeof(size_t)));
+  CHECK(a != b);
+  heap.free(a, sizeof(size_t));
+  size_t *c = static_cast<size_t*>(heap.malloc(sizeof(size_t)));
+  CHECK_EQ(a, c);
+  // different size class
+  void *d = heap.malloc(100);
+  CHECK(d != a);
+  CHECK(d != b);
+  heap.free(b, sizeof(size_t));
+  heap.free(c, sizeof(size_t));
+  heap.free(d, 100);
+}
+
+BOOST_AUTO_TEST_CASE(reset) {
+  Arena::Heap heap;
+  void *first = heap.malloc(64);
+  for (size_t i = 0; i < 1000; ++i)
+    heap.malloc(64);
+  CHECK_EQ(heap.mapped(), size_t(Arena::CHUNK_SIZE));
+  heap.reset();
+  CHECK_EQ(heap.malloc(64), first);
+  CHECK_EQ(heap.mapped(), size_t(Arena::CHUNK_SIZE));
+  heap.release();
+  CHECK_EQ(heap.mapped(), size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(chunks) {
+  Arena::Heap heap;
+  std::set<void*> seen;
+  size_t n = 2 * Arena::CHUNK_SIZE / Arena::MAX_CLASS + 1;
+  for (size_t i = 0; i < n; ++i) {
+    void *x = heap.malloc(Arena::MAX_CLASS);
+    CHECK(seen.insert(x).second);
+  }
+  CHECK_EQ(heap.mapped(), size_t(3 * Arena::CHUNK_SIZE));
+  // big requests bypass the arena
+  void *big = heap.malloc(Arena::MAX_CLASS + 1);
+  heap.free(big, Arena::MAX_CLASS + 1);
+}
+
+struct Elem {
+  size_t a, b, c;
+};
+
+BOOST_AUTO_TEST_CASE(threads) {
+  Pool<Elem> pool;
+  MultiPool<size_t> mpool;
+  std::vector<Arena::Heap*> heaps(4);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < heaps.size(); ++t)
+    threads.push_back(std::thread([&pool, &mpool, &heaps, t] {
+      heaps[t] = &Arena::local();
+      std::vector<Elem*> v;
+      for (size_t i = 0; i < 10000; ++i) {
+        Elem *e = pool.malloc();
+        e->a = e->b = e->c = t;
+        v.push_back(e);
+        size_t *x = mpool.malloc(3);
+        mpool.free(x, 3);
+      }
+      for (size_t i = 0; i < v.size(); ++i) {
+        BOOST_REQUIRE(v[i]->a == t && v[i]->c == t);
+        pool.free(v[i]);
+      }
+    }));
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+  std::set<Arena::Heap*> distinct(heaps.begin(), heaps.end());
+  CHECK_EQ(distinct.size(), heaps.size());
+  Arena::reset();
+}
@@ -0,0 +1,107 @@
+/* {{{
+
+    This file is part of gapc (GAPC - Grammars, Algebras, Products - Compiler;
+      a system to compile algebraic dynamic programming programs)
+
+    Copyright (C) 2008-2011  Georg Sauthoff
+         email: gsauthof@techfak.uni-bielefeld.de or gsauthof@sdf.lonestar.org
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+}}} */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_MODULE dotbracket
+#include <set>
+#include <sstream>
+#include <string>
+#include <boost/test/unit_test.hpp>
+
+#include "../../rtlib/dotbracket.hh"
+
+#include "macros.hh"
+
+static std::string str(const DotBracket &d) {
+  std::ostringstream o;
+  o << d;
+  return o.str();
+}
+
+BOOST_AUTO_TEST_CASE(db_append) {
+  DotBracket d;
+  CHECK(!isEmpty(d));
+  append(d, '(');
+  append(d, '.', 3);
+  append(d, "))", 2);
+  CHECK_EQ(str(d), "(...))");
+  CHECK_EQ(size(d), uint32_t(6));
+  CHECK_EQ(d[0], '(');
+  CHECK_EQ(d[5], ')');
+  DotBracket e;
+  append(e, d);
+  append(e, "[]<>{}_|:,-+");
+  CHECK_EQ(str(e), "(...))[]<>{}_|:,-+");
+  CHECK_EQ(str(d), "(...))");
+  empty(d);
+  CHECK(isEmpty(d));
+}
+
+BOOST_AUTO_TEST_CASE(db_wrap) {
+  DotBracket x("...");
+  DotBracket a = x;
+  for (int i = 0; i < 100; ++i)
+    a = '(' + a + ')';
+  CHECK_EQ(str(a), std::string(100, '(') + "..." + std::string(100, ')'));
+  // x and the intermediate views stay valid
+  CHECK_EQ(str(x), "...");
+  DotBracket b = '[' + x + ']';
+  DotBracket c = '(' + x + ')';
+  CHECK_EQ(str(b), "[...]");
+  CHECK_EQ(str(c), "(...)");
+  CHECK_EQ(str(x + x), "......");
+  CHECK_EQ(str(x + "()"), "...()");
+  CHECK_EQ(str("()" + x), "()...");
+}
+
+BOOST_AUTO_TEST_CASE(db_compare) {
+  const char *s[] = { "", ".", "(", ")", "..", "(.)", "((...))",
+    "((((((((....))))))))..", "((((((((....))))))))...",
+    "((((((((....)))))))).(", "[[..]]", "_[_]_" };
+  const size_t n = sizeof(s) / sizeof(s[0]);
+  std::set<uint32_t> hashes;
+  for (size_t i = 0; i < n; ++i) {
+    DotBracket a(s[i]);
+    // same string at another offset of another buffer
+    DotBracket b = '.' + DotBracket(s[i]);
+    DotBracket t(".");
+    CHECK(a != b || !*s[i]);
+    hashes.insert(a.hashable_value());
+    for (size_t j = 0; j < n; ++j) {
+      DotBracket c = ')' + DotBracket(s[j]);
+      DotBracket d = DotBracket("))") + c;
+      std::string y = std::string(")))") + s[j];
+      DotBracket e;
+      append(e, d);
+      CHECK_EQ(str(e), y);
+      CHECK_EQ(a == DotBracket(s[j]), std::string(s[i]) == s[j]);
+      CHECK_EQ(a < DotBracket(s[j]), std::string(s[i]) < s[j]);
+      CHECK_EQ(b < e, "." + std::string(s[i]) < y);
+      CHECK_EQ(b == e, "." + std::string(s[i]) == y);
+    }
+  }
+  CHECK_EQ(hashes.size(), n);
+  CHECK_EQ(DotBracket("((..))").hashable_value(),
+           ('(' + DotBracket("(..)") + ')').hashable_value());
+}
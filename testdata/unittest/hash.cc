@@ -33,6 +33,7 @@
 #include "macros.hh"
 
 #define STATS
+#define HASH_ADAPTIVE
 #include "../../rtlib/hash.hh"
 
 
@@ -538,3 +539,121 @@ BOOST_AUTO_TEST_CASE(cutoff_big) {
   }
 }
 
+
+#include "../../rtlib/hash_swiss.hh"
+
+BOOST_AUTO_TEST_CASE(swiss_rehash) {
+  Hash::Swiss_Set<size_t, Hash::Default_Inspector<size_t> > set;
+  set.resize(7);
+  for (size_t i = 0; i < 1000; ++i)
+    set.add((i % 500) * (i % 500));
+  set.finalize();
+  std::vector<size_t> l(set.begin(), set.end());
+  CHECK_EQ(l.size(), size_t(500));
+  std::sort(l.begin(), l.end());
+  for (size_t a = 0; a < l.size(); ++a)
+    CHECK_EQ(l[a], a*a);
+}
+
+BOOST_AUTO_TEST_CASE(swiss_values) {
+  typedef std::pair<int , int> tupel;
+  Hash::Swiss_Set<tupel, MyInspector<tupel> > set;
+  set.add(std::make_pair(23, 3));
+  set.add(std::make_pair(23, 7));
+  set.add(std::make_pair(42, 2));
+  set.finalize();
+  Hash::Swiss_Set<tupel, MyInspector<tupel> >::iterator i = set.begin();
+  CHECK(i != set.end());
+  CHECK_EQ((*i).second, 10);
+  ++i;
+  CHECK(i != set.end());
+  CHECK_EQ((*i).second, 2);
+}
+
+BOOST_AUTO_TEST_CASE(swiss_filter) {
+  typedef std::pair<Shape, std::pair<double, double> > tupel;
+  Hash::Swiss_Set<tupel, PfInspector<tupel> > set;
+  tupel t;
+  append(t.first, "[]", 2);
+  t.second.first = 7;
+  t.second.second = 0;
+  set.add(t);
+  append(t.first, "[]", 2);
+  t.second.first = 6;
+  t.second.second = 1;
+  set.add(t);
+  t.second.first = 5;
+  t.second.second = 2;
+  set.add(t);
+  set.filter();
+  set.finalize();
+  size_t n = 0;
+  for (Hash::Swiss_Set<tupel, PfInspector<tupel> >::iterator i =
+       set.begin(); i != set.end(); ++i, ++n) {
+    CHECK_EQ((*i).second.first, 5);
+    CHECK_EQ((*i).second.second, 3);
+  }
+  CHECK_EQ(n, size_t(1));
+}
+
+BOOST_AUTO_TEST_CASE(swiss_cutoff) {
+  typedef std::pair<Shape, int> tupel;
+  Hash::Swiss_Set<tupel, insp_hash_h> set;
+  const char *s[5] = { "[][]", "[[][]][]", "[][][]", "[[][]]", "[][[][]]" };
+  const int v[5] = { -930, -920, -730, -920, -610 };
+  for (int i = 0; i < 5; ++i) {
+    tupel t;
+    append(&t.first, s[i]);
+    t.second = v[i];
+    set.add(t);
+  }
+  set.filter();
+  set.finalize();
+  std::vector<int> r;
+  for (Hash::Swiss_Set<tupel, insp_hash_h>::iterator i = set.begin();
+       i != set.end(); ++i)
+    r.push_back((*i).second);
+  CHECK_EQ(r.size(), size_t(3));
+  if (r.size() == 3) {
+    CHECK_EQ(r[0], -930);
+    CHECK_EQ(r[1], -920);
+    CHECK_EQ(r[2], -920);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(size_stats) {
+  Hash::Size_Stats stats;
+  CHECK_EQ(stats.hint(3, 10), uint32_t(0));
+  stats.record(3, 10, 40);
+  CHECK_EQ(stats.hint(3, 10), uint32_t(40));
+  CHECK_EQ(stats.hint(3, 11), uint32_t(0));
+  CHECK_EQ(stats.hint(4, 10), uint32_t(0));
+  for (int i = 0; i < 20; ++i)
+    stats.record(3, 10, 8);
+  CHECK_EQ(stats.hint(3, 10), uint32_t(8));
+  // long subwords share power of two buckets
+  stats.record(3, 1000, 100);
+  CHECK_EQ(stats.hint(3, 1023), uint32_t(100));
+  CHECK_EQ(stats.hint(3, 1024), uint32_t(0));
+  // unknown non-terminals are ignored
+  stats.record(Hash::Size_Stats::NTS, 10, 5);
+  CHECK_EQ(stats.hint(Hash::Size_Stats::NTS, 10), uint32_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(adaptive) {
+  typedef Hash::Ref<size_t, Hash::Default_Inspector<size_t> > ref;
+  for (int round = 0; round < 2; ++round) {
+    ref h;
+    hash_hint(h, 7, 42);
+    for (size_t i = 0; i < 1000; ++i)
+      push_back(h, (i % 500) * (i % 500) + 1);
+    hash_filter(h, 7, 42);
+    finalize(h);
+    CHECK_EQ(Hash::Size_Stats::instance().hint(7, 42), uint32_t(500));
+    std::vector<size_t> l(h->begin(), h->end());
+    CHECK_EQ(l.size(), size_t(500));
+    std::sort(l.begin(), l.end());
+    for (size_t a = 0; a < l.size(); ++a)
+      CHECK_EQ(l[a], a*a + 1);
+  }
+}
@@ -429,3 +429,103 @@ BOOST_AUTO_TEST_CASE(long_rope_iter) {
   o << r;
   CHECK_EQ(s, o.str());
 }
+
+BOOST_AUTO_TEST_CASE(rope_shared) {
+  Rope r;
+  append(r, "((..))");
+  std::vector<Rope> v(100, r);
+  std::vector<std::string> s(100);
+#ifdef _OPENMP
+  #pragma omp parallel for
+#endif
+  for (int i = 0; i < 100; ++i) {
+    Rope x(v[i]);
+    v[i] = Rope();
+    x.append('.');
+    std::ostringstream o;
+    o << x;
+    s[i] = o.str();
+  }
+  for (int i = 0; i < 100; ++i)
+    CHECK_EQ(s[i], "((..)).");
+  std::ostringstream o;
+  o << r;
+  CHECK_EQ(o.str(), "((..))");
+}
+
+#include "../../rtlib/rope_small.hh"
+
+typedef rope::Ref<rope::Inline> Small_Rope;
+
+static std::string str(const Small_Rope &r) {
+  std::ostringstream o;
+  o << r;
+  return o.str();
+}
+
+BOOST_AUTO_TEST_CASE(small_rope) {
+  Small_Rope r;
+  append(r, "((..))");
+  append(r, '.', 3);
+  append(r, 42);
+  CHECK_EQ(str(r), "((..))...42");
+  CHECK_EQ(r.size(), size_t(11));
+  CHECK_EQ(r.front(), '(');
+  CHECK_EQ(back(r), '2');
+  Small_Rope s(r);
+  append(s, '_', 100);
+  append(s, r);
+  CHECK_EQ(str(r), "((..))...42");
+  CHECK_EQ(str(s), "((..))...42" + std::string(100, '_') + "((..))...42");
+  CHECK_EQ(s.size(), size_t(122));
+  std::string t;
+  for (Small_Rope::iterator i = s.begin(); i != s.end(); ++i)
+    t.push_back(*i);
+  CHECK_EQ(t, str(s));
+  // copies of a spilled rope share its blocks
+  Small_Rope u;
+  append(u, s);
+  CHECK(u == s);
+  append(u, 'x');
+  CHECK(u != s);
+  CHECK_EQ(str(s).size(), size_t(122));
+  CHECK_EQ(str(u), str(s) + "x");
+  CHECK_EQ(u.hashable_value(), Rope(str(u).c_str()).hashable_value());
+}
+
+BOOST_AUTO_TEST_CASE(small_rope_empty) {
+  Small_Rope r;
+  CHECK(!isEmpty(r));
+  empty(r);
+  CHECK(isEmpty(r));
+  Small_Rope s(r);
+  CHECK(isEmpty(s));
+  append(s, "");
+  CHECK(isEmpty(s));
+  append(s, 'x');
+  CHECK(!isEmpty(s));
+  Small_Rope t;
+  t.move(s);
+  CHECK_EQ(str(t), "x");
+  CHECK_EQ(s.size(), size_t(0));
+}
+
+BOOST_AUTO_TEST_CASE(small_rope_order) {
+  const char *s[] = { "", "a", "b", "ab", "ba", "(((...)))",
+    "0123456789012345678901234567890123456789012345678901234567891",
+    "0123456789012345678901234567890123456789012345678901234567892",
+    "01234567890123456789012345678901234567890123456789012345678911",
+    "1123456789012345678901234567890123456789012345678901234567891" };
+  const size_t n = sizeof(s) / sizeof(s[0]);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j) {
+      Rope a, b;
+      append(a, s[i]);
+      append(b, s[j]);
+      Small_Rope x, y;
+      append(x, s[i]);
+      append(y, s[j]);
+      CHECK_EQ(x < y, a < b);
+      CHECK_EQ(x == y, a == b);
+    }
+}
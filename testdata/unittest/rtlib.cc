@@ -42,10 +42,19 @@
 #include "../../rtlib/list.hh"
 #include "../../rtlib/algebra.hh"
 #include "../../rtlib/table.hh"
+#include "../../rtlib/soa.hh"
 #include "../../rtlib/terminal.hh"
 #include "../../rtlib/filter.hh"
 #include "../../rtlib/string.hh"
 #include "../../rtlib/push_back.hh"
+#include "../../rtlib/top_k.hh"
+#include "../../rtlib/pareto_stream.hh"
+#include "../../rtlib/pareto_dom_sort.hh"
+#include "../../rtlib/pareto_parallel.hh"
+#include "../../rtlib/pareto_eps.hh"
+#include "../../rtlib/pareto_auto.hh"
+#include "../../rtlib/backtrack.hh"
+#include "../../rtlib/subopt.hh"
 
 
 BOOST_AUTO_TEST_CASE(listtest) {
@@ -310,6 +319,135 @@ BOOST_AUTO_TEST_CASE(pushback_other) {
   CHECK_EQ(m.ref().front().first, 23);
 }
 
+BOOST_AUTO_TEST_CASE(pushback_top_k) {
+  Top_K::set(3);
+  int v[] = { 17, 4, 99, 23, 8, 42, 4, 61 };
+  List_Ref<int> l;
+  List_Ref<int> m;
+  for (size_t i = 0; i < sizeof(v)/sizeof(int); ++i) {
+    push_back_kmin(l, v[i]);
+    push_back_kmax(m, v[i]);
+    CHECK(l.ref().size() <= size_t(3));
+  }
+  std::pair<List<int>::iterator, List<int>::iterator> p(l.ref().begin(),
+                                                        l.ref().end());
+  List_Ref<int> r = kminimum(p);
+  CHECK_EQ(r.ref().size(), size_t(3));
+  CHECK_EQ(r.ref()[0], 4);
+  CHECK_EQ(r.ref()[1], 4);
+  CHECK_EQ(r.ref()[2], 8);
+
+  std::pair<List<int>::iterator, List<int>::iterator> q(m.ref().begin(),
+                                                        m.ref().end());
+  List_Ref<int> s = kmaximum(q);
+  CHECK_EQ(s.ref().size(), size_t(3));
+  CHECK_EQ(s.ref()[0], 99);
+  CHECK_EQ(s.ref()[1], 61);
+  CHECK_EQ(s.ref()[2], 42);
+
+  List_Ref<int> n;
+  append_kmin(n, l);
+  CHECK_EQ(n.ref().size(), size_t(3));
+}
+
+BOOST_AUTO_TEST_CASE(join_k_classes) {
+  int v[] = { 4, 2, 9, 2, 4, 1 };
+  List_Ref<std::pair<int, int> > l;
+  for (size_t i = 0; i < sizeof(v)/sizeof(int); ++i) {
+    std::pair<int, int> p(v[i], i);
+    push_back(l, p);
+  }
+  List_Ref<int> classes;
+  int c[] = { 2, 4 };
+  for (size_t i = 0; i < sizeof(c)/sizeof(int); ++i)
+    push_back(classes, c[i]);
+
+  List_Ref<std::pair<int, int> > all;
+  join_classes(all, l, classes, false);
+  CHECK_EQ(all.ref().size(), size_t(4));
+  CHECK_EQ(all.ref()[0].second, 1);
+  CHECK_EQ(all.ref()[1].second, 3);
+  CHECK_EQ(all.ref()[2].second, 0);
+  CHECK_EQ(all.ref()[3].second, 4);
+
+  List_Ref<std::pair<int, int> > one;
+  join_classes(one, l, classes, true);
+  CHECK_EQ(one.ref().size(), size_t(2));
+  CHECK_EQ(one.ref()[0].second, 1);
+  CHECK_EQ(one.ref()[1].second, 0);
+}
+
+BOOST_AUTO_TEST_CASE(top_k_frontier) {
+  Top_K::set(4);
+  int a[] = { 9, 1, 5, 3, 7, 2 };
+  int b[] = { 4, 8, 0, 6, 2, 10 };
+  int c[] = { 30, 10, 20 };
+  List_Ref<int> x, y, z;
+  for (size_t i = 0; i < 6; ++i) {
+    push_back(x, a[i]);
+    push_back(y, b[i]);
+  }
+  for (size_t i = 0; i < 3; ++i)
+    push_back(z, c[i]);
+
+  for (int keep_odd = 0; keep_odd < 2; ++keep_odd) {
+    List_Ref<int> all, lazy;
+    for (size_t i = 0; i < 6; ++i)
+      for (size_t j = 0; j < 6; ++j)
+        for (size_t k = 0; k < 3; ++k) {
+          int ans = a[i] + b[j] + c[k];
+          if (keep_odd && !(ans % 2))
+            continue;
+          push_back_kmin(all, ans);
+        }
+    Top_K_Frontier<int, std::less<> > f(lazy, std::less<>(), 3);
+    f.dim(0, x);
+    f.dim(1, y);
+    f.dim(2, z);
+    size_t evals = 0;
+    while (f.next()) {
+      ++evals;
+      int ans = f.at(0, x) + f.at(1, y) + f.at(2, z);
+      if (keep_odd && !(ans % 2))
+        continue;
+      f.push_back(lazy, ans);
+    }
+    CHECK_LESS(evals, size_t(6*6*3));
+    std::pair<List<int>::iterator, List<int>::iterator>
+      p(all.ref().begin(), all.ref().end());
+    std::pair<List<int>::iterator, List<int>::iterator>
+      q(lazy.ref().begin(), lazy.ref().end());
+    List_Ref<int> r = kminimum(p);
+    List_Ref<int> s = kminimum(q);
+    CHECK_EQ(r.ref().size(), size_t(4));
+    CHECK_EQ(s.ref().size(), r.ref().size());
+    for (size_t i = 0; i < r.ref().size(); ++i)
+      CHECK_EQ(s.ref()[i], r.ref()[i]);
+  }
+
+  int single = 100;
+  List_Ref<int> best;
+  Top_K_Frontier<int, std::greater<> > g(best, std::greater<>(), 2);
+  g.dim(0, x);
+  g.dim(1, single);
+  while (g.next()) {
+    int ans = g.at(0, x) + g.at(1, single);
+    g.push_back(best, ans);
+  }
+  std::pair<List<int>::iterator, List<int>::iterator>
+    m(best.ref().begin(), best.ref().end());
+  List_Ref<int> t = kmaximum(m);
+  CHECK_EQ(t.ref().size(), size_t(4));
+  CHECK_EQ(t.ref()[0], 109);
+  CHECK_EQ(t.ref()[3], 103);
+
+  List_Ref<int> none, empty;
+  Top_K_Frontier<int, std::less<> > h(none, std::less<>(), 2);
+  h.dim(0, x);
+  h.dim(1, empty);
+  CHECK(!h.next());
+}
+
 BOOST_AUTO_TEST_CASE(string_rep) {
   String s;
   s.append('.', 5);
@@ -421,3 +559,263 @@ BOOST_AUTO_TEST_CASE(string_neg) {
 }
 
 
+
+BOOST_AUTO_TEST_CASE(soa_table) {
+  typedef std::pair<int, std::pair<double, int> > answer;
+  Table::Soa<answer> array;
+  array.resize(3);
+  CHECK_EQ(array.size(), size_t(3));
+  array[0] = answer(1, std::make_pair(0.5, 2));
+  array[2] = answer(3, std::make_pair(1.5, 4));
+  array[1] = array[2];
+  array[1].first = 5;
+
+  answer a = array[1];
+  CHECK_EQ(a.first, 5);
+  CHECK_EQ(a.second.first, 1.5);
+  CHECK_EQ(a.second.second, 4);
+
+  const Table::Soa<answer> &c = array;
+  CHECK_EQ(c[0].second.second, 2);
+
+  // the primary score is stored contiguously
+  Table::Soa<int> &score = array.first();
+  CHECK_EQ(&score[2] - &score[0], 2);
+  CHECK_EQ(score[0] + score[1] + score[2], 9);
+}
+
+BOOST_AUTO_TEST_CASE(lazy_survives) {
+  typedef std::pair<int, int> answer;
+  List_Ref<answer> l;
+  CHECK(survives_min_other(l, 5));
+  answer a(5, 1);
+  push_back_min_other(l, a);
+  CHECK(survives_min_other(l, 5));
+  CHECK(survives_min_other(l, 4));
+  CHECK(!survives_min_other(l, 6));
+
+  List_Ref<answer> m;
+  push_back_max_other(m, a);
+  CHECK(survives_max_other(m, 6));
+  CHECK(!survives_max_other(m, 4));
+  CHECK(survives(m, 4));
+}
+
+// minimize first, maximize second component - as generated by gapc
+struct pareto_cmp {
+  static const int dim = 2;
+  int operator()(std::pair<int, int> e1, std::pair<int, int> e2, int d) {
+    if (d == 1)
+      return e1.first < e2.first ? 1 : (e1.first == e2.first ? 0 : -1);
+    return e1.second > e2.second ? 1 : (e1.second == e2.second ? 0 : -1);
+  }
+};
+
+struct pareto_cmp_keys : public pareto_cmp {
+  void keys(std::pair<int, int> e1, std::pair<int, int> e2, double *k) {
+    k[0] = e1.first;
+    k[1] = 0 - e1.second;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(pareto_packed) {
+  typedef std::pair<int, int> answer;
+  std::vector<answer> in;
+  for (int i = 0; i < 200; ++i)
+    in.push_back(answer((i * 37) % 101, (i * 53) % 89));
+  in.push_back(in[17]);
+
+  pareto_cmp c;
+  List_Ref<answer> a;
+  pareto_domination_sort(a, in.begin(), in.end(), c);
+  pareto_cmp_keys k;
+  List_Ref<answer> b;
+  pareto_domination_sort(b, in.begin(), in.end(), k);
+
+  CHECK(a.ref().size() > 1);
+  CHECK_EQ(a.ref().size(), b.ref().size());
+  CHECK(std::equal(a.ref().begin(), a.ref().end(), b.ref().begin()));
+}
+
+BOOST_AUTO_TEST_CASE(pareto_split) {
+  typedef std::pair<int, int> answer;
+  std::vector<answer> in;
+  for (int i = 0; i < 500; ++i)
+    in.push_back(answer((i * 37) % 101, (i * 53) % 89));
+
+  pareto_cmp c;
+  List_Ref<answer> a;
+  pareto_domination_sort(a, in.begin(), in.end(), c);
+  std::vector<answer> x(a.ref().begin(), a.ref().end());
+  std::sort(x.begin(), x.end());
+
+  for (size_t parts = 1; parts < 6; ++parts) {
+    std::vector<answer> y;
+    pareto_split_merge(y, in.begin(), in.end(), c, parts);
+    std::sort(y.begin(), y.end());
+    CHECK_EQ(x.size(), y.size());
+    CHECK(std::equal(x.begin(), x.end(), y.begin()));
+  }
+}
+
+// the third component does not take part in the comparison
+struct pareto_cmp_tagged {
+  static const int dim = 2;
+  int operator()(const std::vector<int> &e1, const std::vector<int> &e2,
+                 int d) {
+    if (d == 1)
+      return e1[0] < e2[0] ? 1 : (e1[0] == e2[0] ? 0 : -1);
+    return e1[1] > e2[1] ? 1 : (e1[1] == e2[1] ? 0 : -1);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(pareto_auto_normalized) {
+  typedef std::vector<int> answer;
+  std::vector<answer> in;
+  for (int i = 0; i < 300; ++i)
+    in.push_back(answer({(i * 37) % 41, (i * 53) % 43, i}));
+
+  pareto_cmp_tagged c;
+  List_Ref<answer> a;
+  pareto_domination_sort(a, in.begin(), in.end(), c);
+  std::vector<answer> x(a.ref().begin(), a.ref().end());
+  // first candidate of the input per objective vector, sorted
+  for (size_t i = 0; i < x.size(); ++i)
+    for (size_t j = 0; j < in.size(); ++j)
+      if (in[j][0] == x[i][0] && in[j][1] == x[i][1]) {
+        x[i] = in[j];
+        break;
+      }
+  std::sort(x.begin(), x.end(), [](const answer &l, const answer &r) {
+    return l[0] < r[0] || (l[0] == r[0] && l[1] > r[1]); });
+
+  // runs through all sampled variants and the chosen one
+  for (int k = 0; k < 4 * PARETO_AUTO_SAMPLES; ++k) {
+    List_Ref<answer> b;
+    pareto_auto(b, in.begin(), in.end(), c);
+    std::vector<answer> y(b.ref().begin(), b.ref().end());
+    CHECK_EQ(x.size(), y.size());
+    CHECK(x == y);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(pareto_stream) {
+  // minimize first, maximize second component
+  typedef std::pair<int, int> answer;
+  std::vector<answer> in;
+  for (int i = 0; i < 300; ++i)
+    in.push_back(answer((i * 37) % 41, (i * 53) % 43));
+  in.push_back(in.back());
+
+  List_Ref<answer> l;
+  for (std::vector<answer>::iterator i = in.begin(); i != in.end(); ++i)
+    push_back_pareto_min_max(l, *i);
+  // the list is filled by the finalize call
+  CHECK(isEmpty(l));
+  finalize_pareto_min_max(l);
+
+  std::vector<answer> front;
+  for (size_t i = 0; i < in.size(); ++i) {
+    bool dominated = false;
+    for (size_t j = 0; j < in.size(); ++j)
+      dominated = dominated || (in[j].first <= in[i].first &&
+        in[j].second >= in[i].second && in[j] != in[i]);
+    if (!dominated)
+      front.push_back(in[i]);
+  }
+  std::sort(front.begin(), front.end());
+
+  std::vector<answer> r(l.ref().begin(), l.ref().end());
+  CHECK(std::is_sorted(r.begin(), r.end()));
+  CHECK_EQ(r.size(), front.size());
+  CHECK(std::equal(r.begin(), r.end(), front.begin()));
+
+  // split into two cells, merged by append and pushes after finalize
+  List_Ref<answer> a, b;
+  for (size_t i = 0; i < in.size(); ++i)
+    push_back_pareto_min_max(i % 2 ? a : b, in[i]);
+  finalize_pareto_min_max(a);
+  append_pareto_min_max(a, b);
+  answer d = r.front();
+  push_back_pareto_min_max(a, d);
+  finalize_pareto_min_max(a);
+  std::vector<answer> m(a.ref().begin(), a.ref().end());
+  CHECK_EQ(m.size(), front.size() + 1);
+  m.erase(std::unique(m.begin(), m.end()), m.end());
+  std::vector<answer> u(front);
+  u.erase(std::unique(u.begin(), u.end()), u.end());
+  CHECK(m == u);
+}
+
+BOOST_AUTO_TEST_CASE(pareto_eps_front) {
+  typedef std::pair<int, int> answer;
+  std::vector<answer> in;
+  for (int i = 0; i < 2000; ++i)
+    in.push_back(answer((i * 37) % 1009, (i * 37) % 1009 + i % 7));
+
+  pareto_cmp_keys c;
+  List_Ref<answer> exact;
+  pareto_domination_sort(exact, in.begin(), in.end(), c);
+
+  Pareto_Eps::set(0);
+  List_Ref<answer> zero;
+  pareto_eps(zero, in.begin(), in.end(), c);
+  CHECK_EQ(zero.ref().size(), exact.ref().size());
+
+  Pareto_Eps::set(0.5);
+  List_Ref<answer> a;
+  pareto_eps(a, in.begin(), in.end(), c);
+  CHECK(a.ref().size() < exact.ref().size());
+
+  // every candidate lies in a box that is dominated by a member's box
+  double l = std::log1p(0.5);
+  for (std::vector<answer>::iterator i = in.begin(); i != in.end(); ++i) {
+    bool covered = false;
+    for (List_Ref<answer>::iterator j = a.ref().begin();
+         j != a.ref().end(); ++j)
+      covered = covered ||
+        (pareto_eps_box(j->first, l) <= pareto_eps_box(i->first, l) &&
+         pareto_eps_box(-j->second, l) <= pareto_eps_box(-i->second, l));
+    CHECK(covered);
+  }
+  Pareto_Eps::set(0.01);
+}
+
+BOOST_AUTO_TEST_CASE(lazy_marker) {
+  Marker<unsigned> m;
+  m.init(10);
+  CHECK(!m.is_set(0, 10));
+  m.set(2, 5);
+  CHECK(m.is_set(2, 5));
+  CHECK(!m.is_set(2, 6));
+  CHECK(!m.is_set(3, 5));
+  m.set(10, 10);
+  CHECK(m.is_set(10, 10));
+  m.init(10);
+  CHECK(!m.is_set(2, 5));
+}
+
+BOOST_AUTO_TEST_CASE(string_shared) {
+  String t;
+  t.append('(');
+  t.append('.');
+  t.append(')');
+  std::vector<String> v(100, t);
+  std::vector<std::string> s(100);
+#ifdef _OPENMP
+  #pragma omp parallel for
+#endif
+  for (int i = 0; i < 100; ++i) {
+    String x(v[i]);
+    v[i] = String();
+    x.append('.');
+    std::ostringstream o;
+    o << x;
+    s[i] = o.str();
+  }
+  for (int i = 0; i < 100; ++i)
+    CHECK_EQ(s[i], "(.).");
+  std::ostringstream o;
+  o << t;
+  CHECK_EQ(o.str(), "(.)");
+}
@@ -52,3 +52,69 @@ BOOST_AUTO_TEST_CASE(dists) {
   CHECK_LESS(std::fabs(static_cast<double>(array[2])/30000.0-1.0), 0.01);
 }
 
+
+BOOST_AUTO_TEST_CASE(philox_streams) {
+  // known answer of Random123 for key 0, counter 0
+  scil::philox::state s;
+  scil::philox::select(&s, 0, 0);
+  scil::philox::block(&s);
+  CHECK_EQ(s.out[0], uint32_t(0x6627e8d5));
+  CHECK_EQ(s.out[3], uint32_t(0x9b00dbd8));
+
+  scil::rng a(scil::philox::type()), b(scil::philox::type());
+  a.stream(42, 7);
+  b.stream(42, 6);
+  b.stream(42, 7);
+  for (size_t i = 0; i < 10; ++i)
+    CHECK_EQ(gsl_rng_get(*a), gsl_rng_get(*b));
+  b.stream(42, 8);
+  CHECK_NOT_EQ(gsl_rng_get(*a), gsl_rng_get(*b));
+}
+
+BOOST_AUTO_TEST_CASE(cached_tables) {
+  scil::discrete_cache c;
+  std::vector<double> w;
+  w.push_back(5);
+  w.push_back(2);
+  w.push_back(3);
+  scil::sample_cell(1, 0, 3);
+  scil::cell_key k = scil::current_cell();
+  k.m = w.size();
+  CHECK(!c.find(k));
+  gsl_ran_discrete_t *t = c.insert(k, w);
+  CHECK(t);
+  CHECK_EQ(c.find(k), t);
+  k.idx[1] = 4;
+  CHECK(!c.find(k));
+  k.idx[1] = 3;
+  k.m = 2;
+  CHECK(!c.find(k));
+}
+
+
+BOOST_AUTO_TEST_CASE(batch_draws) {
+  scil::streams() = true;
+  std::ostringstream o;
+  std::vector<unsigned long> first, second;
+  scil::draw_batch(o, 100, 42, [&](std::ostream &) {
+    const std::vector<unsigned> &b = scil::batch();
+    CHECK_EQ(b.size(), size_t(100));
+    for (size_t i = 0; i < b.size(); ++i) {
+      scil::batch_sample s(b[i]);
+      first.push_back(gsl_rng_get(*scil::local_rng()));
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+      scil::batch_sample s(b[i]);
+      second.push_back(gsl_rng_get(*scil::local_rng()));
+    }
+  });
+  CHECK(scil::batch().empty());
+
+  // sample i continues stream (42, i)
+  scil::rng r(scil::philox::type());
+  for (unsigned i = 0; i < 100; ++i) {
+    r.stream(42, i);
+    CHECK_EQ(first[i], gsl_rng_get(*r));
+    CHECK_EQ(second[i], gsl_rng_get(*r));
+  }
+}
@@ -594,3 +594,153 @@ BOOST_AUTO_TEST_CASE(tailer) {
   o << tail(a);
   CHECK_EQ(o.str(), "[][]");
 }
+
+#include "../../rtlib/shape_intern.hh"
+
+typedef Interned_Shape<Shape_Fiber> IShape;
+
+BOOST_AUTO_TEST_CASE(intern_ids) {
+  IShape a;
+  a.append('[');
+  a.append('_');
+  a.append(']');
+  IShape b('[');
+  b.append(IShape("_]"));
+  CHECK_EQ(a.index(), b.index());
+  CHECK(a == b);
+  CHECK_EQ(hashable_value(a), hashable_value(b));
+  IShape c(Shape_Fiber("[]"));
+  CHECK_NOT_EQ(a.index(), c.index());
+  CHECK(c.index() < Shape_Table<Shape_Fiber>::instance().size());
+  size_t n = Shape_Table<Shape_Fiber>::instance().size();
+  for (int i = 0; i < 100; ++i)
+    CHECK(a + c == b + c);
+  CHECK_EQ(n + 1, Shape_Table<Shape_Fiber>::instance().size());
+  IShape d;
+  d.append('_');
+  CHECK_EQ(d, '_');
+  CHECK_NOT_EQ(d, '[');
+  IShape e;
+  e.empty();
+  CHECK(isEmpty(e));
+  e.append(d);
+  CHECK(e == d);
+}
+
+BOOST_AUTO_TEST_CASE(intern_fiber) {
+  boost::minstd_rand generator(42);
+  boost::uniform_int<> uni_dist(0, 2);
+  boost::variate_generator<boost::minstd_rand&, boost::uniform_int<> >
+    uni(generator, uni_dist);
+  const char alph[] = "[]_";
+  for (int k = 0; k < 200; ++k) {
+    Shape_Fiber f;
+    IShape s;
+    int n = 1 + k % 23;
+    for (int i = 0; i < n; ++i) {
+      char c = alph[uni()];
+      f.append(c);
+      s.append(c);
+    }
+    CHECK(s.fiber() == f);
+    std::ostringstream o, p;
+    o << f;
+    p << s;
+    CHECK_EQ(o.str(), p.str());
+    CHECK_EQ(front(f), front(s));
+    CHECK_EQ(back(f), back(s));
+    std::ostringstream q, r;
+    q << tail(f);
+    r << tail(s);
+    CHECK_EQ(q.str(), r.str());
+    CHECK_EQ(f.size(), s.size());
+  }
+  IShape a("[_]");
+  IShape b("[]");
+  CHECK_EQ(a < b, a.fiber() < b.fiber());
+  CHECK_EQ(b < a, b.fiber() < a.fiber());
+  CHECK(!(a < a));
+  std::ostringstream o;
+  o << push_before_back(a, ']', '_');
+  CHECK_EQ(o.str(), "[__]");
+}
+
+#include "../../rtlib/shape_small.hh"
+
+typedef Small_Shape<Shape_Fiber> SShape;
+
+BOOST_AUTO_TEST_CASE(small_shape) {
+  SShape a;
+  a.append('[');
+  a.append('_');
+  a.append(']');
+  SShape b('[');
+  b.append(SShape("_]"));
+  CHECK(a == b);
+  CHECK_EQ(hashable_value(a), hashable_value(b));
+  CHECK_EQ(a.size(), size_t(3));
+  SShape c;
+  for (int i = 0; i < 29; ++i)
+    c.append(i % 2 ? ']' : '[');
+  SShape d(c);
+  d.append('_');
+  CHECK_EQ(d.size(), size_t(30));
+  CHECK_EQ(back(d), '_');
+  CHECK(tail(tail(d)) != d);
+  Shape_Fiber f;
+  for (SShape::iterator i = d.begin(); i != d.end(); ++i)
+    f.append(*i);
+  CHECK(SShape(f) == d);
+  CHECK(SShape(f) != c);
+  SShape e;
+  e.append('_');
+  CHECK_EQ(e, '_');
+  CHECK_NOT_EQ(e, '[');
+  SShape g("[G]");
+  CHECK_EQ(g.size(), size_t(3));
+  std::ostringstream o;
+  o << g;
+  CHECK_EQ(o.str(), "[G]");
+}
+
+BOOST_AUTO_TEST_CASE(small_fiber) {
+  boost::minstd_rand generator(23);
+  boost::uniform_int<> uni_dist(0, 2);
+  boost::variate_generator<boost::minstd_rand&, boost::uniform_int<> >
+    uni(generator, uni_dist);
+  const char alph[] = "[]_";
+  for (int k = 0; k < 200; ++k) {
+    Shape_Fiber f, g;
+    SShape s, t;
+    int n = 1 + k % 37;
+    for (int i = 0; i < n; ++i) {
+      char c = alph[uni()];
+      f.append(c);
+      s.append(c);
+      if (i % 3) {
+        g.append(c);
+        t.append(c);
+      }
+    }
+    f.append(g);
+    s.append(t);
+    std::ostringstream o, p;
+    o << f;
+    p << s;
+    CHECK_EQ(o.str(), p.str());
+    CHECK_EQ(f.size(), s.size());
+    CHECK_EQ(front(f), front(s));
+    CHECK_EQ(back(f), back(s));
+    std::ostringstream q, r;
+    q << tail(f);
+    r << tail(s);
+    CHECK_EQ(q.str(), r.str());
+    std::ostringstream u, v;
+    u << push_after_front(f, '[', '_') << push_before_back(f, ']', '_');
+    v << push_after_front(s, '[', '_') << push_before_back(s, ']', '_');
+    CHECK_EQ(u.str(), v.str());
+  }
+  CHECK(SShape("[]") < SShape("[]_"));
+  CHECK(SShape("[[") < SShape("[]"));
+  CHECK(!(SShape("[]") < SShape("[]")));
+}